@@ -0,0 +1,117 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "point2-file.h"
+
+struct Point2File {
+  const char *fileName;
+  void *data;           /** mapped or allocated contents of file */
+  size_t size;          /** # of bytes in data */
+  bool isMapped;        /** data is mmap()'d rather than malloc()'d */
+};
+
+static void __attribute__((noreturn))
+fail(const char *msg, const char *fileName)
+{
+  fprintf(stderr, "%s %s: %s\n", msg, fileName, strerror(errno));
+  exit(1);
+}
+
+/** Read fd into point2File->data.  If size is non-zero, it is the
+ *  fstat() size of a regular file, which is read in one allocation;
+ *  otherwise fd is read until EOF, doubling the buffer as needed.
+ */
+static void
+readPoint2File(int fd, size_t size, Point2File *point2File)
+{
+  enum { INIT_SIZE = 1 << 16 };
+  const bool isSized = size > 0;
+  if (!isSized) size = INIT_SIZE;
+  char *data = malloc(size);
+  if (!data) fail("cannot allocate buffer for", point2File->fileName);
+  size_t nRead = 0;
+  for (;;) {
+    if (nRead == size) {
+      if (isSized) break;
+      size *= 2;
+      data = realloc(data, size);
+      if (!data) fail("cannot grow buffer for", point2File->fileName);
+    }
+    ssize_t nBytes = read(fd, data + nRead, size - nRead);
+    if (nBytes < 0 && errno == EINTR) continue;
+    if (nBytes < 0) fail("cannot read", point2File->fileName);
+    if (nBytes == 0) break;
+    nRead += nBytes;
+  }
+  point2File->data = data;
+  point2File->size = nRead;
+}
+
+/** Return newly opened Point2File for file fileName.  Exits on error. */
+Point2File *
+openPoint2File(const char *fileName)
+{
+  Point2File *point2File = calloc(1, sizeof(Point2File));
+  if (!point2File) fail("cannot alloc Point2File for", fileName);
+  point2File->fileName = fileName;
+  int fd = open(fileName, O_RDONLY);
+  if (fd < 0) fail("cannot read", fileName);
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0) fail("cannot stat", fileName);
+  const bool isRegular = S_ISREG(fileStat.st_mode);
+  const size_t size = isRegular ? fileStat.st_size : 0;
+  if (size > 0) {
+    void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      //points are scanned front to back
+      posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+      point2File->data = data;
+      point2File->size = size;
+      point2File->isMapped = true;
+    }
+  }
+  if (!point2File->isMapped && !(isRegular && size == 0)) {
+    readPoint2File(fd, size, point2File);
+  }
+  if (close(fd) != 0) fail("cannot close", fileName);
+  return point2File;
+}
+
+/** Unmap or free all resources used by point2File */
+void
+closePoint2File(Point2File *point2File)
+{
+  if (point2File->isMapped) {
+    munmap(point2File->data, point2File->size);
+  }
+  else {
+    free(point2File->data);
+  }
+  free(point2File);
+}
+
+/** Return the Point2 records of point2File; a trailing partial record
+ *  is ignored.
+ */
+const Point2 *
+pointsPoint2File(const Point2File *point2File)
+{
+  return point2File->data;
+}
+
+/** Return # of Point2 records in point2File */
+size_t
+nPointsPoint2File(const Point2File *point2File)
+{
+  return point2File->size/sizeof(Point2);
+}
@@ -0,0 +1,29 @@
+#ifndef POINT2_FILE_H_
+#define POINT2_FILE_H_
+
+#include <stddef.h>
+
+#include "point2.h"
+
+//A binary file of Point2 records accessed in place as a read-only
+//array.  Regular files are mmap()'d; other files (pipes, devices) or
+//files which cannot be mapped are read into memory in bulk.
+
+//set up as an ADT
+typedef struct Point2File Point2File;
+
+/** Return newly opened Point2File for file fileName.  Exits on error. */
+Point2File *openPoint2File(const char *fileName);
+
+/** Unmap or free all resources used by point2File */
+void closePoint2File(Point2File *point2File);
+
+/** Return the Point2 records of point2File; a trailing partial record
+ *  is ignored.
+ */
+const Point2 *pointsPoint2File(const Point2File *point2File);
+
+/** Return # of Point2 records in point2File */
+size_t nPointsPoint2File(const Point2File *point2File);
+
+#endif //ifndef POINT2_FILE_H_
@@ -0,0 +1,158 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "point2-sort.h"
+
+//Each pass of the LSD radix sort stably scatters points by one
+//RADIX_BITS digit of their squared magnitude, from least to most
+//significant.  The first pass reads the input points; later passes
+//scatter back and forth between sorted[] and a single scratch array.
+//The key is recomputed from each point whenever a digit is needed
+//rather than being stored alongside it, which keeps the extra memory
+//down to one Point2 per point.  The points are split into one
+//contiguous chunk per thread: in each pass every thread first counts
+//the digits in its chunk, then computes where each of its digits goes
+//from the counts of all threads and scatters its chunk there.  Since
+//all threads share the same counts, they all skip the same passes in
+//which every key has the same digit.
+
+enum {
+  RADIX_BITS = 8,
+  N_BUCKETS = 1 << RADIX_BITS,
+  N_PASSES = 64/RADIX_BITS,
+
+  //fewest points worth giving to a thread
+  MIN_CHUNK = 1 << 16
+};
+
+/** State shared by all threads of one sort */
+typedef struct {
+  const Point2 *points;
+  Point2 *sorted;
+  size_t n;
+  int nThreads;
+  Point2 *scratch;      /** points are scattered between it and sorted */
+  size_t (*counts)[N_BUCKETS];  /** [nThreads][N_BUCKETS] digit counts */
+  pthread_barrier_t barrier;
+} Sort;
+
+typedef struct {
+  Sort *sort;
+  int index;            /** of thread, 0 ... nThreads - 1 */
+} Worker;
+
+/** Return digit pass of the squared magnitude of p */
+static inline unsigned
+digit(const Point2 *p, int pass)
+{
+  return (squaredMagnitudePoint2(p) >> (pass*RADIX_BITS)) & (N_BUCKETS - 1);
+}
+
+static void *
+sortChunk(void *arg)
+{
+  const Worker *worker = arg;
+  Sort *sort = worker->sort;
+  const int t = worker->index;
+  const size_t lo = sort->n*t/sort->nThreads;
+  const size_t hi = sort->n*(t + 1)/sort->nThreads;
+  size_t *counts = sort->counts[t];
+
+  const Point2 *src = sort->points;
+  for (int pass = 0; pass < N_PASSES; pass++) {
+    memset(counts, 0, N_BUCKETS*sizeof(size_t));
+    for (size_t i = lo; i < hi; i++) counts[digit(&src[i], pass)]++;
+    pthread_barrier_wait(&sort->barrier);
+
+    //points with digit d from this chunk go after all points with
+    //smaller digits and after those with digit d from earlier chunks
+    size_t offsets[N_BUCKETS];
+    size_t offset = 0;
+    int nDigits = 0;    //# of distinct digits in this pass
+    for (int d = 0; d < N_BUCKETS; d++) {
+      size_t total = 0;
+      for (int k = 0; k < sort->nThreads; k++) {
+        if (k == t) offsets[d] = offset + total;
+        total += sort->counts[k][d];
+      }
+      offset += total;
+      nDigits += total > 0;
+    }
+    if (nDigits > 1) {
+      Point2 *dest = (src == sort->sorted) ? sort->scratch : sort->sorted;
+      for (size_t i = lo; i < hi; i++) {
+        dest[offsets[digit(&src[i], pass)]++] = src[i];
+      }
+      src = dest;
+    }
+    //counts are rewritten and points read by other threads next pass
+    pthread_barrier_wait(&sort->barrier);
+  }
+  if (src != sort->sorted) {
+    memcpy(&sort->sorted[lo], &src[lo], (hi - lo)*sizeof(Point2));
+  }
+  return NULL;
+}
+
+static void __attribute__((noreturn))
+fail(const char *msg)
+{
+  fprintf(stderr, "%s: %s\n", msg, strerror(errno));
+  exit(1);
+}
+
+/** Set sorted[0, n) to points[0, n) in increasing order of their exact
+ *  squared magnitudes x*x + y*y; points with equal magnitudes keep
+ *  their order (the sort is stable).  Uses an LSD radix sort on
+ *  nThreads threads, or one thread per online processor if nThreads
+ *  <= 0.  Exits on error.
+ */
+void
+sortPoint2s(const Point2 points[], size_t n, Point2 sorted[], int nThreads)
+{
+  if (n == 0) return;
+  if (nThreads <= 0) {
+    const long nProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+    nThreads = (nProcessors > 0) ? nProcessors : 1;
+  }
+  const size_t maxThreads = (n > MIN_CHUNK) ? n/MIN_CHUNK : 1;
+  if (maxThreads < (size_t)nThreads) nThreads = maxThreads;
+  Sort sort = {
+    .points = points,
+    .sorted = sorted,
+    .n = n,
+    .nThreads = nThreads,
+    .scratch = malloc(n*sizeof(Point2)),
+    .counts = malloc(nThreads*sizeof(*sort.counts)),
+  };
+  Worker *workers = malloc(nThreads*sizeof(Worker));
+  pthread_t *threads = malloc(nThreads*sizeof(pthread_t));
+  if (!sort.scratch || !sort.counts || !workers || !threads) {
+    fail("cannot allocate sort buffers");
+  }
+  errno = pthread_barrier_init(&sort.barrier, NULL, nThreads);
+  if (errno != 0) fail("cannot create barrier");
+
+  //this thread sorts chunk 0
+  for (int t = 0; t < nThreads; t++) {
+    workers[t] = (Worker) { .sort = &sort, .index = t };
+    if (t == 0) continue;
+    errno = pthread_create(&threads[t], NULL, sortChunk, &workers[t]);
+    if (errno != 0) fail("cannot create sort thread");
+  }
+  sortChunk(&workers[0]);
+  for (int t = 1; t < nThreads; t++) pthread_join(threads[t], NULL);
+
+  pthread_barrier_destroy(&sort.barrier);
+  free(sort.scratch);
+  free(sort.counts);
+  free(workers);
+  free(threads);
+}
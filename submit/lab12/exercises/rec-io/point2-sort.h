@@ -0,0 +1,17 @@
+#ifndef POINT2_SORT_H_
+#define POINT2_SORT_H_
+
+#include <stddef.h>
+
+#include "point2.h"
+
+/** Set sorted[0, n) to points[0, n) in increasing order of their exact
+ *  squared magnitudes x*x + y*y; points with equal magnitudes keep
+ *  their order (the sort is stable).  Uses an LSD radix sort on
+ *  nThreads threads, or one thread per online processor if nThreads
+ *  <= 0.  Exits on error.
+ */
+void sortPoint2s(const Point2 points[], size_t n, Point2 sorted[],
+                 int nThreads);
+
+#endif //ifndef POINT2_SORT_H_
@@ -0,0 +1,114 @@
+#include <assert.h>
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "point2-stats.h"
+
+static inline void
+swap(uint64_t *a, uint64_t *b)
+{
+  uint64_t t = *a;
+  *a = *b;
+  *b = t;
+}
+
+/** Return the k'th smallest (from 0) of keys[0, n), k < n, partially
+ *  reordering keys.  Quickselect with a median-of-3 pivot and a
+ *  3-way partition, so runs of equal keys (common with small
+ *  coordinates) are not repartitioned.
+ */
+static uint64_t
+selectKey(uint64_t keys[], size_t n, size_t k)
+{
+  assert(k < n);
+  size_t lo = 0, hi = n;        //k is in [lo, hi)
+  while (hi - lo > 1) {
+    const size_t mid = lo + (hi - lo)/2;
+    uint64_t a = keys[lo], b = keys[mid], c = keys[hi - 1];
+    const uint64_t pivot =
+      (a < b) ? ((b < c) ? b : (a < c) ? c : a)
+              : ((a < c) ? a : (b < c) ? c : b);
+    //[lo, lt) < pivot, [lt, i) == pivot, [gt, hi) > pivot
+    size_t lt = lo, i = lo, gt = hi;
+    while (i < gt) {
+      if (keys[i] < pivot) {
+        swap(&keys[lt++], &keys[i++]);
+      }
+      else if (keys[i] > pivot) {
+        swap(&keys[i], &keys[--gt]);
+      }
+      else {
+        i++;
+      }
+    }
+    if (k < lt) {
+      hi = lt;
+    }
+    else if (k >= gt) {
+      lo = gt;
+    }
+    else {
+      return pivot;
+    }
+  }
+  return keys[lo];
+}
+
+/** Set *stats to the statistics of the magnitudes of points[0, n),
+ *  n > 0, in O(n) time: a single pass computes every squared magnitude
+ *  along with the min, max and sum and the median is found by
+ *  selection on the squared magnitudes.
+ */
+void
+statsPoint2s(const Point2 points[], size_t n, Point2Stats *stats)
+{
+  assert(n > 0);
+  uint64_t *keys = malloc(n*sizeof(uint64_t));
+  if (!keys) {
+    fprintf(stderr, "cannot allocate %zu keys: %s\n", n, strerror(errno));
+    exit(1);
+  }
+  //branch-free, with LANES independent partial results, so that the
+  //compiler can vectorize it; min, max and sum use the same double
+  //arithmetic as magnitudePoint2(), while the keys are exact
+  enum { LANES = 4 };
+  double mins[LANES], maxs[LANES], sums[LANES];
+  for (int j = 0; j < LANES; j++) {
+    mins[j] = INFINITY;
+    maxs[j] = sums[j] = 0;
+  }
+  size_t i = 0;
+  for (; i + LANES <= n; i += LANES) {
+    for (int j = 0; j < LANES; j++) {
+      const Point2 *p = &points[i + j];
+      keys[i + j] = squaredMagnitudePoint2(p);
+      const double sq = 1.0*p->x*p->x + 1.0*p->y*p->y;
+      mins[j] = (sq < mins[j]) ? sq : mins[j];
+      maxs[j] = (sq > maxs[j]) ? sq : maxs[j];
+      sums[j] += sqrt(sq);
+    }
+  }
+  for (; i < n; i++) {
+    const Point2 *p = &points[i];
+    keys[i] = squaredMagnitudePoint2(p);
+    const double sq = 1.0*p->x*p->x + 1.0*p->y*p->y;
+    mins[0] = (sq < mins[0]) ? sq : mins[0];
+    maxs[0] = (sq > maxs[0]) ? sq : maxs[0];
+    sums[0] += sqrt(sq);
+  }
+  double minSq = mins[0], maxSq = maxs[0], sum = 0;
+  for (int j = 0; j < LANES; j++) {
+    minSq = (mins[j] < minSq) ? mins[j] : minSq;
+    maxSq = (maxs[j] > maxSq) ? maxs[j] : maxSq;
+    sum += sums[j];
+  }
+  stats->min = sqrt(minSq);
+  stats->max = sqrt(maxSq);
+  stats->average = sum/n;
+  stats->median = sqrt((double)selectKey(keys, n, n/2));
+  free(keys);
+}
@@ -0,0 +1,23 @@
+#ifndef POINT2_STATS_H_
+#define POINT2_STATS_H_
+
+#include <stddef.h>
+
+#include "point2.h"
+
+/** Statistics of the magnitudes of a set of points */
+typedef struct {
+  double min;
+  double max;
+  double average;
+  double median;       /** upper median: element n/2 in sorted order */
+} Point2Stats;
+
+/** Set *stats to the statistics of the magnitudes of points[0, n),
+ *  n > 0, in O(n) time: a single pass computes every squared magnitude
+ *  along with the min, max and sum and the median is found by
+ *  selection on the squared magnitudes.
+ */
+void statsPoint2s(const Point2 points[], size_t n, Point2Stats *stats);
+
+#endif //ifndef POINT2_STATS_H_
@@ -1,7 +1,8 @@
 #ifndef POINT2_H_
-#define POINT2_H
+#define POINT2_H_
 
 #include <math.h>
+#include <stdint.h>
 
 typedef struct {
   int x, y;
@@ -11,4 +12,13 @@ static double inline magnitudePoint2(const Point2 *p) {
   return sqrt(1.0*p->x*p->x + 1.0*p->y*p->y);
 }
 
+/** Return the exact squared magnitude of p (at most 2**63); the
+ *  unsigned 32x32 -> 64-bit products vectorize on any x86-64.
+ */
+static inline uint64_t squaredMagnitudePoint2(const Point2 *p) {
+  const uint64_t x = (p->x < 0) ? 0u - (uint32_t)p->x : (uint32_t)p->x;
+  const uint64_t y = (p->y < 0) ? 0u - (uint32_t)p->y : (uint32_t)p->y;
+  return x*x + y*y;
+}
+
 #endif //ifndef POINT2_H_
@@ -1,79 +1,72 @@
-#include <assert.h>
 #include <errno.h>
-#include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
-#include "dyn-array.h"
 #include "point2.h"
+#include "point2-file.h"
+#include "point2-sort.h"
+#include "point2-stats.h"
 
 static void
-readPoints(const char *inName, DynArray *points)
+statPoints(const Point2 points[], size_t n, FILE *out)
 {
-  FILE *in = fopen(inName, "rb");
-  if (!in) {
-    fprintf(stderr, "cannot read %s: %s\n", inName, strerror(errno));
-    exit(1);
-  }
-  Point2 point2;
-  while (fread(&point2, sizeof(Point2), 1, in) == 1) {
-    addElementDynArray(points, &point2);
-  }
-  if (fclose(in) != 0) {
-    fprintf(stderr, "cannot close %s: %s\n", inName, strerror(errno));
-    exit(1);
-  }
-}
-
-static int
-comparePoint2(const void *p1, const void *p2)
-{
-  return magnitudePoint2(p1) - magnitudePoint2(p2);
-}
-
-static double
-averagePoints(const DynArray *points)
-{
-  const int n = nElementsDynArray(points);
-  assert(n > 0);
-  double sum = 0;
-  for (int i = 0; i < n; i++) {
-    const Point2 *p = getElementDynArray(points, i);
-    double mag = magnitudePoint2(p);
-    sum += mag;
+  if (n > 0) {
+    Point2Stats stats;
+    statsPoint2s(points, n, &stats);
+    fprintf(out, "min = %g\naverage = %g\nmedian = %g\nmax = %g\n",
+            stats.min, stats.average, stats.median, stats.max);
   }
-  return sum/n;
 }
 
+/** Write points[0, n) sorted by magnitude to binary file outName */
 static void
-statPoints(DynArray *points, FILE *out)
+writeSortedPoints(const Point2 points[], size_t n, const char *outName)
 {
-  sortDynArray(points, comparePoint2);
-  const int n = nElementsDynArray(points);
-  if (n > 0) {
-    double min = magnitudePoint2(getElementDynArray(points, 0));
-    double max = magnitudePoint2(getElementDynArray(points, n - 1));
-    double average = averagePoints(points);
-    double median = magnitudePoint2(getElementDynArray(points, n/2));
-    fprintf(out, "min = %g\naverage = %g\nmedian = %g\nmax = %g\n",
-            min, average, median, max);
+  FILE *out = fopen(outName, "wb");
+  if (!out) {
+    fprintf(stderr, "cannot write %s: %s\n", outName, strerror(errno));
+    exit(1);
+  }
+  Point2 *sorted = malloc(n*sizeof(Point2));
+  if (n > 0 && !sorted) {
+    fprintf(stderr, "cannot allocate %zu points: %s\n", n, strerror(errno));
+    exit(1);
+  }
+  sortPoint2s(points, n, sorted, 0);
+  if (fwrite(sorted, sizeof(Point2), n, out) != n) {
+    fprintf(stderr, "cannot write %s: %s\n", outName, strerror(errno));
+    exit(1);
+  }
+  free(sorted);
+  if (fclose(out) != 0) {
+    fprintf(stderr, "cannot close %s: %s\n", outName, strerror(errno));
+    exit(1);
   }
 }
 
 int
 main(int argc, const char *argv[])
 {
+  const char *sortedName = NULL;
+  if (argc > 2 && strcmp(argv[1], "-s") == 0) {
+    sortedName = argv[2];
+    argc -= 2;
+    argv += 2;
+  }
   if (argc < 2) {
-    fprintf(stderr, "usage: %s BINARY_POINTS_FILE STATISTIC_OUTPUT_FILE(Optional)\n", argv[0]);
+    fprintf(stderr, "usage: %s [-s SORTED_POINTS_FILE] BINARY_POINTS_FILE STATISTIC_OUTPUT_FILE(Optional)\n", argv[0]);
     exit(1);
   }
   FILE *stat_out = stdout;
   if (argc == 3) stat_out = fopen(argv[2], "a");
-  DynArray *points = newDynArray(sizeof(Point2));
-  readPoints(argv[1], points);
-  statPoints(points, stat_out);
-  freeDynArray(points);
+  Point2File *points = openPoint2File(argv[1]);
+  statPoints(pointsPoint2File(points), nPointsPoint2File(points), stat_out);
+  if (sortedName) {
+    writeSortedPoints(pointsPoint2File(points), nPointsPoint2File(points),
+                      sortedName);
+  }
+  closePoint2File(points);
   fclose(stat_out);
   return 0;
 }
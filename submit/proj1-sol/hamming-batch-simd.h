@@ -0,0 +1,142 @@
+//Vector kernels for hamming-batch.c.  This file is included once per
+//instruction set with HAMMING_SIMD(name) giving the name used for each
+//function and HAMMING_SIMD_LANES the # of words in a vector; it uses
+//GCC vector extensions so the same source serves every target.  When
+//HAMMING_SIMD_POPCNT is non-zero, parities use the AVX-512 vector
+//popcount instead of bit-sliced folding.
+//
+//Each kernel handles the largest multiple of HAMMING_SIMD_LANES words
+//<= n, returns that count and leaves the remaining words to the
+//caller.  The parities of every group are computed for all lanes at
+//once and data bits are moved by the same shift-and-merge steps as the
+//portable scalar code, since there is no vector pdep/pext.
+
+#define Vec HAMMING_SIMD(Vec)
+
+typedef unsigned long long Vec
+  __attribute__((vector_size(8*HAMMING_SIMD_LANES)));
+
+static inline Vec
+HAMMING_SIMD(load)(const HammingWord *p)
+{
+  Vec v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline void
+HAMMING_SIMD(store)(HammingWord *p, Vec v)
+{
+  memcpy(p, &v, sizeof(v));
+}
+
+/** Syndrome of each lane of w: see get_syndrome() in hamming.c */
+#if HAMMING_SIMD_POPCNT
+
+static inline Vec
+HAMMING_SIMD(syndrome)(Vec w, unsigned nParityBits)
+{
+  Vec syndrome = { 0 };
+  for (unsigned k = 0; k < nParityBits; k++) {
+    const Vec group = w & PARITY_GROUP_MASKS[k];
+    syndrome |= ((Vec)_mm512_popcnt_epi64((__m512i)group) & 1) << k;
+  }
+  return syndrome;
+}
+
+#else //!HAMMING_SIMD_POPCNT
+
+static inline Vec
+HAMMING_SIMD(syndrome)(Vec w, unsigned nParityBits)
+{
+  // Bit-sliced: all group masks but the last repeat every 32 bits and
+  // the first 4 every 16 bits, so fold w in halves and pack the folded
+  // bits under each group mask into separate 32- or 16-bit fields of
+  // a lane; folding the fields together leaves each group's parity in
+  // the lowest bit of its field.
+  const HammingWord low32 = 0xFFFFFFFFULL;
+  const HammingWord fields16 =
+    (PARITY_GROUP_MASKS[0] & 0xFFFF) |
+    (PARITY_GROUP_MASKS[1] & 0xFFFF) << 16 |
+    (PARITY_GROUP_MASKS[2] & 0xFFFF) << 32 |
+    (PARITY_GROUP_MASKS[3] & 0xFFFF) << 48;
+
+  const Vec w32 = (w ^ (w >> 32)) & low32;
+  const Vec group5 = w & PARITY_GROUP_MASKS[5];
+  Vec fields32 = ((group5 ^ (group5 >> 32)) & low32) |
+    (w32 & PARITY_GROUP_MASKS[4] & low32) << 32;
+  for (int shift = 16; shift > 0; shift /= 2) {
+    fields32 ^= fields32 >> shift;
+  }
+
+  Vec w16 = (w32 ^ (w32 >> 16)) & 0xFFFF;
+  w16 |= w16 << 16;
+  Vec fields = (w16 | w16 << 32) & fields16;
+  for (int shift = 8; shift > 0; shift /= 2) {
+    fields ^= fields >> shift;
+  }
+
+  const Vec syndrome =
+    (fields & 0x1) | (fields >> 15 & 0x2) | (fields >> 30 & 0x4) |
+    (fields >> 45 & 0x8) | (fields32 >> 28 & 0x10) | (fields32 << 5 & 0x20);
+  return syndrome & ((1u << nParityBits) - 1);
+}
+
+#endif //if HAMMING_SIMD_POPCNT
+
+static size_t
+HAMMING_SIMD(encode_n)(const HammingWord *in, HammingWord *out, size_t n,
+                       unsigned nParityBits)
+{
+  const HammingWord parityMask = PARITY_POSITION_MASKS[nParityBits];
+  size_t i;
+  for (i = 0; i + HAMMING_SIMD_LANES <= n; i += HAMMING_SIMD_LANES) {
+    // insert a 0 at each parity bit, lowest first
+    Vec w = HAMMING_SIMD(load)(&in[i]);
+    for (HammingWord m = parityMask; m != 0; m &= m - 1) {
+      const HammingWord below = (m & -m) - 1;
+      w = (w & below) | ((w & ~below) << 1);
+    }
+    // with the parity bits still 0, bit k of the syndrome is the value
+    // of the parity bit at 2**k
+    const Vec syndrome = HAMMING_SIMD(syndrome)(w, nParityBits);
+    for (unsigned k = 0; k < nParityBits; k++) {
+      w |= (syndrome >> k & 1) << ((1 << k) - 1);
+    }
+    HAMMING_SIMD(store)(&out[i], w);
+  }
+  return i;
+}
+
+static size_t
+HAMMING_SIMD(decode_n)(const HammingWord *in, HammingWord *out, size_t n,
+                       unsigned nParityBits, unsigned long long *errors,
+                       size_t *nErrors)
+{
+  const HammingWord parityMask = PARITY_POSITION_MASKS[nParityBits];
+  size_t i;
+  for (i = 0; i + HAMMING_SIMD_LANES <= n; i += HAMMING_SIMD_LANES) {
+    Vec w = HAMMING_SIMD(load)(&in[i]);
+    const Vec syndrome = HAMMING_SIMD(syndrome)(w, nParityBits);
+    const Vec isError = (Vec)(syndrome != 0);
+    w ^= (((Vec){ 0 } + 1) << ((syndrome - 1) & 63)) & isError;
+
+    // squeeze out each parity bit, highest first
+    for (HammingWord m = parityMask; m != 0; ) {
+      const HammingWord below = (1ULL << (63 - __builtin_clzll(m))) - 1;
+      w = (w & below) | ((w >> 1) & ~below);
+      m &= below;
+    }
+    HAMMING_SIMD(store)(&out[i], w);
+
+    unsigned long long bits = 0;
+    for (int k = 0; k < HAMMING_SIMD_LANES; k++) {
+      bits |= (isError[k] & 1ULL) << k;
+    }
+    *nErrors += __builtin_popcountll(bits);
+    if (errors) errors[i / 64] |= bits << (i % 64);
+  }
+  return i;
+}
+
+#undef Vec
@@ -0,0 +1,105 @@
+#include "hamming-batch.h"
+#include "hamming-masks.h"
+
+#include <assert.h>
+#include <string.h>
+
+#ifndef HAMMING_BATCH_SIMD
+  #define HAMMING_BATCH_SIMD 1
+#endif
+
+#if HAMMING_BATCH_SIMD && !defined(__x86_64__)
+  #undef HAMMING_BATCH_SIMD
+  #define HAMMING_BATCH_SIMD 0
+#endif
+
+#if HAMMING_BATCH_SIMD
+
+#include <immintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#define HAMMING_SIMD(name) name##_avx2
+#define HAMMING_SIMD_LANES 4
+#define HAMMING_SIMD_POPCNT 0
+#include "hamming-batch-simd.h"
+#undef HAMMING_SIMD
+#undef HAMMING_SIMD_LANES
+#undef HAMMING_SIMD_POPCNT
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512vpopcntdq")
+#define HAMMING_SIMD(name) name##_avx512
+#define HAMMING_SIMD_LANES 8
+#define HAMMING_SIMD_POPCNT 1
+#include "hamming-batch-simd.h"
+#undef HAMMING_SIMD
+#undef HAMMING_SIMD_LANES
+#undef HAMMING_SIMD_POPCNT
+#pragma GCC pop_options
+
+typedef enum { SIMD_NONE, SIMD_AVX2, SIMD_AVX512 } SimdLevel;
+
+static SimdLevel
+get_simd_level(void)
+{
+  static int level = -1;
+  if (level < 0) {
+    __builtin_cpu_init();
+    level =
+      (__builtin_cpu_supports("avx512f") &&
+       __builtin_cpu_supports("avx512vpopcntdq")) ? SIMD_AVX512
+      : __builtin_cpu_supports("avx2") ? SIMD_AVX2
+      : SIMD_NONE;
+  }
+  return level;
+}
+
+#define SIMD_KERNEL(kernel, ...) \
+  ((get_simd_level() == SIMD_AVX512) ? kernel##_avx512(__VA_ARGS__) \
+   : (get_simd_level() == SIMD_AVX2) ? kernel##_avx2(__VA_ARGS__) \
+   : 0)
+
+#else //!HAMMING_BATCH_SIMD
+
+#define SIMD_KERNEL(kernel, ...) 0
+
+#endif //if HAMMING_BATCH_SIMD
+
+/** Set out[i] to hamming_encode_fast(in[i], nParityBits) for
+ *  0 <= i < n.
+ */
+void
+hamming_encode_n(const HammingWord *in, HammingWord *out, size_t n,
+                 unsigned nParityBits)
+{
+  assert(0 < nParityBits && nParityBits <= 6);
+  size_t i = SIMD_KERNEL(encode_n, in, out, n, nParityBits);
+  for (; i < n; i++) {
+    out[i] = hamming_encode_fast(in[i], nParityBits);
+  }
+}
+
+/** Set out[i] to hamming_decode_fast(in[i], nParityBits) for
+ *  0 <= i < n, recording corrected words in the errors bitmap.
+ */
+size_t
+hamming_decode_n(const HammingWord *in, HammingWord *out, size_t n,
+                 unsigned nParityBits, unsigned long long *errors)
+{
+  assert(0 < nParityBits && nParityBits <= 6);
+  if (errors) memset(errors, 0, HAMMING_N_ERROR_WORDS(n)*sizeof(*errors));
+  size_t nErrors = 0;
+  size_t i = SIMD_KERNEL(decode_n, in, out, n, nParityBits, errors,
+                         &nErrors);
+  for (; i < n; i++) {
+    int isError = 0;
+    out[i] = hamming_decode_fast(in[i], nParityBits, &isError);
+    if (isError) {
+      nErrors++;
+      if (errors) errors[i / 64] |= 1ULL << (i % 64);
+    }
+  }
+  return nErrors;
+}
@@ -0,0 +1,35 @@
+#ifndef HAMMING_BATCH_H_
+#define HAMMING_BATCH_H_
+
+#include "hamming.h"
+
+#include <stddef.h>
+
+//Batch versions of the fast Hamming encoder and decoder which operate
+//on n words of contiguous arrays; nParityBits must be in 1 ... 6.
+//Word i of the output is what the single-word function returns for
+//word i of the input.  out may be the same array as in.
+//
+//AVX2 (4 words) and AVX-512 (8 words) kernels are selected at run time
+//when available (compile with -DHAMMING_BATCH_SIMD=0 to always use the
+//scalar loops).
+
+/** Set out[i] to hamming_encode_fast(in[i], nParityBits) for
+ *  0 <= i < n.
+ */
+void hamming_encode_n(const HammingWord *in, HammingWord *out, size_t n,
+                      unsigned nParityBits);
+
+/** Set out[i] to hamming_decode_fast(in[i], nParityBits) for
+ *  0 <= i < n.  If errors is not NULL, it must have room for
+ *  HAMMING_N_ERROR_WORDS(n) words: bit i % 64 of errors[i / 64] is set
+ *  to 1 iff an error was corrected in word i.  Returns the # of words
+ *  with a corrected error.
+ */
+size_t hamming_decode_n(const HammingWord *in, HammingWord *out, size_t n,
+                        unsigned nParityBits, unsigned long long *errors);
+
+/** # of words in the error bitmap for n words */
+#define HAMMING_N_ERROR_WORDS(n) (((n) + 63) / 64)
+
+#endif //ifndef HAMMING_BATCH_H_
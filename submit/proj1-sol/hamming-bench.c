@@ -0,0 +1,249 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "hamming.h"
+#include "hamming-batch.h"
+#include "hamming-block.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//Time every Hamming encoder and decoder for each nParityBits over
+//random words, writing one CSV line per function and nParityBits.
+//Decoder inputs have a single-bit error in every other word.  Block
+//codes count each 64-bit limb of an encoded block as a word.
+
+enum {
+  DEFAULT_N_WORDS = 1 << 18,
+  MAX_PARITY_BITS = 6,
+
+  //each measurement is repeated and the fastest run reported
+  N_REPEATS = 3
+};
+
+//result of every operation is accumulated here so it cannot be
+//optimized away
+static volatile unsigned long long sink;
+
+/** Return a 64-bit pseudo-random number (xorshift64) */
+static unsigned long long
+random64(void)
+{
+  static unsigned long long state = 0x2545F4914F6CDD1DULL;
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+static double
+now_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec*1e9 + t.tv_nsec;
+}
+
+typedef enum {
+  ENCODE, ENCODE_FAST, ENCODE_N, ENCODE_SECDED,
+  DECODE, DECODE_FAST, DECODE_N, DECODE_SECDED, N_FNS
+} Fn;
+
+static const char *FN_NAMES[] = {
+  "hamming_encode", "hamming_encode_fast", "hamming_encode_n",
+  "hamming_encode_secded",
+  "hamming_decode", "hamming_decode_fast", "hamming_decode_n",
+  "hamming_decode_secded",
+};
+
+static bool
+is_decode(Fn fn)
+{
+  return fn >= DECODE;
+}
+
+static bool
+is_secded(Fn fn)
+{
+  return fn == ENCODE_SECDED || fn == DECODE_SECDED;
+}
+
+/** Fill in[0 ... n) with the input for fn: random data words, or their
+ *  encodings with a single-bit error in every other word.
+ */
+static void
+fill_input(Fn fn, unsigned p, HammingWord in[], size_t n)
+{
+  const unsigned nCodeBits = is_secded(fn) ? 1u << p : (1u << p) - 1;
+  const unsigned nDataBits = is_secded(fn) ? nCodeBits - 1 - p : 64 - p;
+  for (size_t i = 0; i < n; i++) {
+    HammingWord data = random64() & ((1ULL << nDataBits) - 1);
+    if (!is_decode(fn)) {
+      in[i] = data;
+      continue;
+    }
+    in[i] = is_secded(fn) ? hamming_encode_secded(data, p)
+                          : hamming_encode_fast(data, p);
+    if (i % 2) in[i] ^= 1ULL << random64() % nCodeBits;
+  }
+}
+
+/** Return the time in ns for running fn over in[0 ... n) */
+static double
+time_fn(Fn fn, unsigned p, const HammingWord in[], HammingWord out[],
+        size_t n)
+{
+  unsigned long long acc = 0;
+  double start = now_ns();
+  switch (fn) {
+    case ENCODE:
+      for (size_t i = 0; i < n; i++) acc += hamming_encode(in[i], p);
+      break;
+    case ENCODE_FAST:
+      for (size_t i = 0; i < n; i++) acc += hamming_encode_fast(in[i], p);
+      break;
+    case ENCODE_N:
+      hamming_encode_n(in, out, n, p);
+      acc += out[n - 1];
+      break;
+    case ENCODE_SECDED:
+      for (size_t i = 0; i < n; i++) acc += hamming_encode_secded(in[i], p);
+      break;
+    case DECODE:
+      for (size_t i = 0; i < n; i++) {
+        int hasError = 0;
+        acc += hamming_decode(in[i], p, &hasError);
+      }
+      break;
+    case DECODE_FAST:
+      for (size_t i = 0; i < n; i++) {
+        int hasError = 0;
+        acc += hamming_decode_fast(in[i], p, &hasError);
+      }
+      break;
+    case DECODE_N:
+      acc += hamming_decode_n(in, out, n, p, NULL) + out[n - 1];
+      break;
+    case DECODE_SECDED:
+      for (size_t i = 0; i < n; i++) {
+        HammingStatus status;
+        acc += hamming_decode_secded(in[i], p, &status);
+      }
+      break;
+    default:
+      break;
+  }
+  double elapsed = now_ns() - start;
+  sink += acc;
+  return elapsed;
+}
+
+/** Time block encoding and decoding of about n limbs with
+ *  nParityBits, printing a CSV line for each.
+ */
+static void
+bench_block(unsigned nParityBits, size_t n)
+{
+  HammingBlockCode code;
+  if (init_hamming_block_code(&code, nParityBits) != 0) return;
+  const size_t nBlocks = (n + code.nLimbs - 1)/code.nLimbs;
+  HammingLimb *data = calloc(nBlocks*code.nDataLimbs, sizeof(HammingLimb));
+  HammingLimb *encoded = calloc(nBlocks*code.nLimbs, sizeof(HammingLimb));
+  HammingLimb *decoded = calloc(code.nDataLimbs, sizeof(HammingLimb));
+  if (!data || !encoded || !decoded) {
+    fprintf(stderr, "cannot allocate %zu blocks\n", nBlocks);
+    exit(1);
+  }
+  for (size_t i = 0; i < nBlocks*code.nDataLimbs; i++) data[i] = random64();
+
+  const char *names[] = { "hamming_block_encode", "hamming_block_decode" };
+  for (int isDecode = 0; isDecode < 2; isDecode++) {
+    double best = 0;
+    for (int r = 0; r < N_REPEATS; r++) {
+      unsigned long long acc = 0;
+      double start = now_ns();
+      for (size_t b = 0; b < nBlocks; b++) {
+        HammingLimb *e = &encoded[b*code.nLimbs];
+        if (isDecode) {
+          int hasError;
+          hamming_block_decode(&code, e, decoded, &hasError);
+          acc += decoded[0] + hasError;
+        }
+        else {
+          hamming_block_encode(&code, &data[b*code.nDataLimbs], e);
+        }
+      }
+      double ns = now_ns() - start;
+      sink += acc;
+      if (r == 0 || ns < best) best = ns;
+    }
+    const size_t nWords = nBlocks*code.nLimbs;
+    const double nsPerWord = best/nWords;
+    printf("%u,%s,%zu,%.2f,%.2f\n", nParityBits, names[isDecode], nWords,
+           nsPerWord, 1e3/nsPerWord);
+  }
+  free(data);
+  free(encoded);
+  free(decoded);
+  free_hamming_block_code(&code);
+}
+
+static void
+usage(const char *prog)
+{
+  fprintf(stderr, "usage: %s [-H] [N_WORDS]\n", prog);
+  fprintf(stderr, "  -H: do not output a CSV header line\n");
+  exit(1);
+}
+
+int
+main(int argc, char *argv[])
+{
+  bool isHeader = true;
+  size_t nWords = DEFAULT_N_WORDS;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-H") == 0) {
+      isHeader = false;
+    }
+    else {
+      char *end;
+      nWords = strtoul(argv[i], &end, 10);
+      if (*end != '\0' || nWords == 0) usage(argv[0]);
+    }
+  }
+  HammingWord *in = calloc(nWords, sizeof(HammingWord));
+  HammingWord *out = calloc(nWords, sizeof(HammingWord));
+  if (!in || !out) {
+    fprintf(stderr, "cannot allocate %zu words\n", nWords);
+    exit(1);
+  }
+
+  if (isHeader) {
+    printf("n_parity_bits,function,n_words,ns_per_word,mwords_per_s\n");
+  }
+  for (unsigned p = 1; p <= MAX_PARITY_BITS; p++) {
+    for (Fn fn = 0; fn < N_FNS; fn++) {
+      if (is_secded(fn) && p < 2) continue;  //no room for data bits
+      fill_input(fn, p, in, nWords);
+      double best = 0;
+      for (int r = 0; r < N_REPEATS; r++) {
+        double ns = time_fn(fn, p, in, out, nWords);
+        if (r == 0 || ns < best) best = ns;
+      }
+      const double nsPerWord = best/nWords;
+      printf("%u,%s,%zu,%.2f,%.2f\n", p, FN_NAMES[fn], nWords, nsPerWord,
+             1e3/nsPerWord);
+    }
+  }
+  const unsigned blockParityBits[] = { 7, 8, 12 };
+  for (size_t i = 0; i < sizeof(blockParityBits)/sizeof(blockParityBits[0]);
+       i++) {
+    bench_block(blockParityBits[i], nWords);
+  }
+
+  free(in);
+  free(out);
+  return 0;
+}
@@ -0,0 +1,177 @@
+#include "hamming-block.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+  LIMB_BITS = 64,
+  LOG2_LIMB_BITS = 6,
+
+  //limb 0 holds the parity bits at 1, 2, 4, ..., 32 and the unused
+  //bit 0, leaving this many data bits
+  N_LIMB0_DATA_BITS = LIMB_BITS - LOG2_LIMB_BITS - 1
+};
+
+/** Group masks within a limb for the parity bits 2**k, k < 6: bit i
+ *  is set iff bit k of i is 1.  Parity bits 2**k, k >= 6 cover whole
+ *  limbs instead.
+ */
+static const HammingLimb LIMB_GROUP_MASKS[LOG2_LIMB_BITS] = {
+  0xAAAAAAAAAAAAAAAAULL,
+  0xCCCCCCCCCCCCCCCCULL,
+  0xF0F0F0F0F0F0F0F0ULL,
+  0xFF00FF00FF00FF00ULL,
+  0xFFFF0000FFFF0000ULL,
+  0xFFFFFFFF00000000ULL,
+};
+
+int
+init_hamming_block_code(HammingBlockCode *code, unsigned nParityBits)
+{
+  if (nParityBits < HAMMING_BLOCK_MIN_PARITY_BITS ||
+      nParityBits > HAMMING_BLOCK_MAX_PARITY_BITS) {
+    return 1;
+  }
+  code->nParityBits = nParityBits;
+  code->nBits = ((size_t)1 << nParityBits) - 1;
+  code->nDataBits = code->nBits - nParityBits;
+  code->nLimbs = (code->nBits + 1)/LIMB_BITS;
+  code->nDataLimbs = (code->nDataBits + LIMB_BITS - 1)/LIMB_BITS;
+  code->groupMasks =
+    malloc(nParityBits*code->nLimbs*sizeof(HammingLimb));
+  if (!code->groupMasks) return 1;
+  for (unsigned k = 0; k < nParityBits; k++) {
+    HammingLimb *masks = &code->groupMasks[k*code->nLimbs];
+    for (size_t j = 0; j < code->nLimbs; j++) {
+      masks[j] = (k < LOG2_LIMB_BITS) ? LIMB_GROUP_MASKS[k]
+        : ((j >> (k - LOG2_LIMB_BITS)) & 1) ? ~0ULL : 0;
+    }
+  }
+  return 0;
+}
+
+void
+free_hamming_block_code(HammingBlockCode *code)
+{
+  free(code->groupMasks);
+  code->groupMasks = NULL;
+}
+
+/** Return the syndrome of encoded: bit k is the parity of the bits
+ *  under group mask k.  The parity of a sum of popcounts is the
+ *  popcount parity of the XOR of the masked limbs, so each group is
+ *  folded with AND/XOR (which the compiler vectorizes) and only a
+ *  single popcount is needed per parity bit.
+ */
+static size_t
+get_syndrome(const HammingBlockCode *code, const HammingLimb encoded[])
+{
+  const size_t nLimbs = code->nLimbs;
+  size_t syndrome = 0;
+  for (unsigned k = 0; k < code->nParityBits; k++) {
+    const HammingLimb *masks = &code->groupMasks[k*nLimbs];
+    HammingLimb acc = 0;
+    for (size_t j = 0; j < nLimbs; j++) acc ^= encoded[j] & masks[j];
+    syndrome |= (size_t)__builtin_parityll(acc) << k;
+  }
+  return syndrome;
+}
+
+/** Return the n <= 64 bits of data starting at bit offset */
+static HammingLimb
+get_data_bits(const HammingLimb data[], size_t offset, unsigned n)
+{
+  const size_t j = offset/LIMB_BITS;
+  const unsigned shift = offset%LIMB_BITS;
+  HammingLimb bits = data[j] >> shift;
+  if (shift + n > LIMB_BITS) bits |= data[j + 1] << (LIMB_BITS - shift);
+  return (n < LIMB_BITS) ? bits & ((1ULL << n) - 1) : bits;
+}
+
+/** OR the n <= 64 bits of bits into data starting at bit offset */
+static void
+or_data_bits(HammingLimb data[], size_t offset, unsigned n,
+             HammingLimb bits)
+{
+  const size_t j = offset/LIMB_BITS;
+  const unsigned shift = offset%LIMB_BITS;
+  data[j] |= bits << shift;
+  if (shift + n > LIMB_BITS) data[j + 1] |= bits >> (LIMB_BITS - shift);
+}
+
+/** Return the N_LIMB0_DATA_BITS low bits of data deposited at the
+ *  non-parity bits 3, 5 ... 7, 9 ... 15, 17 ... 31, 33 ... 63 of limb 0.
+ */
+static HammingLimb
+deposit_limb0(HammingLimb data)
+{
+  return
+    (data & 0x1ULL) << 3 |
+    (data >> 1 & 0x7ULL) << 5 |
+    (data >> 4 & 0x7FULL) << 9 |
+    (data >> 11 & 0x7FFFULL) << 17 |
+    (data >> 26 & 0x7FFFFFFFULL) << 33;
+}
+
+/** Inverse of deposit_limb0() */
+static HammingLimb
+extract_limb0(HammingLimb limb)
+{
+  return
+    (limb >> 3 & 0x1ULL) |
+    (limb >> 5 & 0x7ULL) << 1 |
+    (limb >> 9 & 0x7FULL) << 4 |
+    (limb >> 17 & 0x7FFFULL) << 11 |
+    (limb >> 33 & 0x7FFFFFFFULL) << 26;
+}
+
+/** Return # of data bits in limb j >= 1: limbs 1, 2, 4, ... hold a
+ *  parity bit in bit 0.
+ */
+static unsigned
+n_limb_data_bits(size_t j)
+{
+  return (j & (j - 1)) == 0 ? LIMB_BITS - 1 : LIMB_BITS;
+}
+
+void
+hamming_block_encode(const HammingBlockCode *code,
+                     const HammingLimb data[], HammingLimb encoded[])
+{
+  encoded[0] = deposit_limb0(get_data_bits(data, 0, N_LIMB0_DATA_BITS));
+  size_t offset = N_LIMB0_DATA_BITS;
+  for (size_t j = 1; j < code->nLimbs; j++) {
+    const unsigned n = n_limb_data_bits(j);
+    const HammingLimb bits = get_data_bits(data, offset, n);
+    encoded[j] = (n < LIMB_BITS) ? bits << 1 : bits;
+    offset += n;
+  }
+  //with all parity bits 0, the syndrome is the parity bits
+  const size_t syndrome = get_syndrome(code, encoded);
+  for (unsigned k = 0; k < code->nParityBits; k++) {
+    const size_t bitIndex = (size_t)1 << k;
+    encoded[bitIndex/LIMB_BITS] |=
+      (HammingLimb)(syndrome >> k & 1) << bitIndex%LIMB_BITS;
+  }
+}
+
+void
+hamming_block_decode(const HammingBlockCode *code,
+                     const HammingLimb encoded[], HammingLimb data[],
+                     int *hasError)
+{
+  const size_t syndrome = get_syndrome(code, encoded);
+  *hasError = syndrome != 0;
+  const HammingLimb flip0 =
+    (syndrome/LIMB_BITS == 0) ? (HammingLimb)(syndrome != 0) << syndrome : 0;
+  memset(data, 0, code->nDataLimbs*sizeof(HammingLimb));
+  data[0] = extract_limb0(encoded[0] ^ flip0);
+  size_t offset = N_LIMB0_DATA_BITS;
+  for (size_t j = 1; j < code->nLimbs; j++) {
+    HammingLimb limb = encoded[j];
+    if (syndrome/LIMB_BITS == j) limb ^= 1ULL << syndrome%LIMB_BITS;
+    const unsigned n = n_limb_data_bits(j);
+    or_data_bits(data, offset, n, (n < LIMB_BITS) ? limb >> 1 : limb);
+    offset += n;
+  }
+}
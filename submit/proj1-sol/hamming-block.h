@@ -0,0 +1,55 @@
+#ifndef HAMMING_BLOCK_H_
+#define HAMMING_BLOCK_H_
+
+#include <stddef.h>
+
+//Hamming codes longer than a HammingWord: a code with nParityBits
+//parity bits is nBits = 2**nParityBits - 1 bits long (127, 255, ...,
+//4095, ...) and is held in an array of 64-bit limbs, least-significant
+//limb first.  bitIndex i (1 ... nBits) is bit i % 64 of limb i / 64;
+//bit 0 of limb 0 is unused and always 0, so an encoded block occupies
+//exactly 2**nParityBits bits.  Data bits are packed into the low
+//nDataBits bits of their limbs.
+
+typedef unsigned long long HammingLimb;
+
+enum {
+  HAMMING_BLOCK_MIN_PARITY_BITS = 7,   //shorter codes fit a HammingWord
+  HAMMING_BLOCK_MAX_PARITY_BITS = 16
+};
+
+/** A block code and its precomputed parity-group (column) masks */
+typedef struct {
+  unsigned nParityBits;
+  size_t nBits;               //# of bits in code: 2**nParityBits - 1
+  size_t nDataBits;           //nBits - nParityBits
+  size_t nLimbs;              //# of limbs for an encoded block
+  size_t nDataLimbs;          //# of limbs for the data of a block
+  HammingLimb *groupMasks;    //nParityBits masks of nLimbs limbs each
+} HammingBlockCode;
+
+/** Initialize code for nParityBits in HAMMING_BLOCK_MIN_PARITY_BITS
+ *  ... HAMMING_BLOCK_MAX_PARITY_BITS.  Return 0 on success, non-zero
+ *  if nParityBits is out of range or memory cannot be allocated.
+ */
+int init_hamming_block_code(HammingBlockCode *code, unsigned nParityBits);
+
+/** Free all memory used by code */
+void free_hamming_block_code(HammingBlockCode *code);
+
+/** Set encoded[0 ... code->nLimbs) to the encoding of the
+ *  code->nDataBits bits in data[0 ... code->nDataLimbs); any higher
+ *  bits in the last data limb are ignored.
+ */
+void hamming_block_encode(const HammingBlockCode *code,
+                          const HammingLimb data[], HammingLimb encoded[]);
+
+/** Set data[0 ... code->nDataLimbs) to the data bits of
+ *  encoded[0 ... code->nLimbs) after correcting any single-bit error.
+ *  Set *hasError to non-zero if an error is detected.
+ */
+void hamming_block_decode(const HammingBlockCode *code,
+                          const HammingLimb encoded[], HammingLimb data[],
+                          int *hasError);
+
+#endif //ifndef HAMMING_BLOCK_H_
@@ -0,0 +1,227 @@
+#include "hamming-interleave.h"
+
+#include <assert.h>
+#include <string.h>
+
+#ifndef HAMMING_INTERLEAVE_SIMD
+  #define HAMMING_INTERLEAVE_SIMD 1
+#endif
+
+#if HAMMING_INTERLEAVE_SIMD && !defined(__x86_64__)
+  #undef HAMMING_INTERLEAVE_SIMD
+  #define HAMMING_INTERLEAVE_SIMD 0
+#endif
+
+//Both group sizes are built from delta swaps between pairs of rows
+//(words) k and k + j with bit j of k clear: the bits of row k selected
+//by mask << shift are exchanged with the bits of row k + j selected by
+//mask.  A 64x64 bit transpose is the 6 rounds j = shift = 32 ... 1.
+//An interleaved group of 8 words is the byte-wise 8x8 transpose of
+//the words (3 rounds j = 4 ... 1, shift = 8*j) followed by an 8x8 bit
+//transpose within each word.
+
+/** ROUND_MASKS[i] is the mask for rounds with shift 32 >> i */
+static const HammingWord ROUND_MASKS[] = {
+  0x00000000FFFFFFFFULL,
+  0x0000FFFF0000FFFFULL,
+  0x00FF00FF00FF00FFULL,
+  0x0F0F0F0F0F0F0F0FULL,
+  0x3333333333333333ULL,
+  0x5555555555555555ULL,
+};
+
+static void
+swap_rows(HammingWord rows[], unsigned nRows, unsigned j, unsigned shift,
+          HammingWord mask)
+{
+  for (unsigned k = 0; k < nRows; k++) {
+    if (k & j) continue;
+    const HammingWord t = ((rows[k] >> shift) ^ rows[k + j]) & mask;
+    rows[k + j] ^= t;
+    rows[k] ^= t << shift;
+  }
+}
+
+/** Return word with its bytes as rows of an 8x8 bit matrix transposed */
+static HammingWord
+transpose_8x8(HammingWord x)
+{
+  HammingWord t;
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;  x ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL; x ^= t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL; x ^= t ^ (t << 28);
+  return x;
+}
+
+static void
+transpose_64x64(HammingWord rows[])
+{
+  for (unsigned i = 0, j = 32; j > 0; i++, j >>= 1) {
+    swap_rows(rows, 64, j, j, ROUND_MASKS[i]);
+  }
+}
+
+/** Transpose the bytes of the 8 rows as an 8x8 byte matrix */
+static void
+transpose_bytes(HammingWord rows[])
+{
+  for (unsigned i = 0, j = 4; j > 0; i++, j >>= 1) {
+    swap_rows(rows, 8, j, 8*j, ROUND_MASKS[i]);
+  }
+}
+
+static void
+interleave_8(HammingWord rows[])
+{
+  transpose_bytes(rows);
+  for (int k = 0; k < 8; k++) rows[k] = transpose_8x8(rows[k]);
+}
+
+static void
+deinterleave_8(HammingWord rows[])
+{
+  for (int k = 0; k < 8; k++) rows[k] = transpose_8x8(rows[k]);
+  transpose_bytes(rows);
+}
+
+
+#if HAMMING_INTERLEAVE_SIMD
+
+//The same kernels on AVX2 vectors of 4 rows: rounds with j >= 4 pair
+//whole vectors; rounds with j < 4 pair lanes within a vector by
+//shuffling it.
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+typedef HammingWord WordVec __attribute__((vector_size(32)));
+
+static void
+swap_rows_avx2(WordVec v[], unsigned nRows, unsigned j, unsigned shift,
+               HammingWord mask)
+{
+  if (j >= 4) {
+    const unsigned jv = j/4;
+    for (unsigned k = 0; k < nRows/4; k++) {
+      if (k & jv) continue;
+      const WordVec t = ((v[k] >> shift) ^ v[k + jv]) & mask;
+      v[k + jv] ^= t;
+      v[k] ^= t << shift;
+    }
+    return;
+  }
+  const WordVec lanes = (j == 1) ? (WordVec){ mask, 0, mask, 0 }
+                                 : (WordVec){ mask, mask, 0, 0 };
+  for (unsigned k = 0; k < nRows/4; k++) {
+    const WordVec other = (j == 1)
+      ? __builtin_shuffle(v[k], (WordVec){ 1, 0, 3, 2 })
+      : __builtin_shuffle(v[k], (WordVec){ 2, 3, 0, 1 });
+    const WordVec t = ((v[k] >> shift) ^ other) & lanes;
+    const WordVec tOther = (j == 1)
+      ? __builtin_shuffle(t, (WordVec){ 1, 0, 3, 2 })
+      : __builtin_shuffle(t, (WordVec){ 2, 3, 0, 1 });
+    v[k] ^= (t << shift) ^ tOther;
+  }
+}
+
+static WordVec
+transpose_8x8_avx2(WordVec x)
+{
+  WordVec t;
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;  x ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL; x ^= t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL; x ^= t ^ (t << 28);
+  return x;
+}
+
+static void
+transpose_64x64_avx2(HammingWord rows[])
+{
+  WordVec v[16];
+  memcpy(v, rows, sizeof(v));
+  for (unsigned i = 0, j = 32; j > 0; i++, j >>= 1) {
+    swap_rows_avx2(v, 64, j, j, ROUND_MASKS[i]);
+  }
+  memcpy(rows, v, sizeof(v));
+}
+
+static void
+interleave_8_avx2(HammingWord rows[], int isInverse)
+{
+  WordVec v[2];
+  memcpy(v, rows, sizeof(v));
+  for (int pass = 0; pass < 2; pass++) {
+    if (pass == isInverse) {
+      for (unsigned i = 0, j = 4; j > 0; i++, j >>= 1) {
+        swap_rows_avx2(v, 8, j, 8*j, ROUND_MASKS[i]);
+      }
+    }
+    else {
+      v[0] = transpose_8x8_avx2(v[0]);
+      v[1] = transpose_8x8_avx2(v[1]);
+    }
+  }
+  memcpy(rows, v, sizeof(v));
+}
+
+#pragma GCC pop_options
+
+static int
+has_avx2(void)
+{
+  static int hasAvx2 = -1;
+  if (hasAvx2 < 0) {
+    __builtin_cpu_init();
+    hasAvx2 = __builtin_cpu_supports("avx2");
+  }
+  return hasAvx2;
+}
+
+#endif //if HAMMING_INTERLEAVE_SIMD
+
+/** Apply the interleaving or its inverse to each complete group */
+static void
+code_groups(HammingWord words[], size_t n, unsigned groupSize,
+            int isInverse)
+{
+  assert(groupSize == HAMMING_INTERLEAVE_SMALL ||
+         groupSize == HAMMING_INTERLEAVE_LARGE);
+#if HAMMING_INTERLEAVE_SIMD
+  const int isAvx2 = has_avx2();
+#endif
+  for (size_t i = 0; i + groupSize <= n; i += groupSize) {
+    HammingWord *rows = &words[i];
+#if HAMMING_INTERLEAVE_SIMD
+    if (isAvx2) {
+      if (groupSize == HAMMING_INTERLEAVE_LARGE) {
+        transpose_64x64_avx2(rows);
+      }
+      else {
+        interleave_8_avx2(rows, isInverse);
+      }
+      continue;
+    }
+#endif
+    if (groupSize == HAMMING_INTERLEAVE_LARGE) {
+      transpose_64x64(rows);
+    }
+    else if (isInverse) {
+      deinterleave_8(rows);
+    }
+    else {
+      interleave_8(rows);
+    }
+  }
+}
+
+void
+hamming_interleave(HammingWord words[], size_t n, unsigned groupSize)
+{
+  code_groups(words, n, groupSize, 0);
+}
+
+void
+hamming_deinterleave(HammingWord words[], size_t n, unsigned groupSize)
+{
+  code_groups(words, n, groupSize, 1);
+}
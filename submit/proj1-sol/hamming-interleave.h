@@ -0,0 +1,29 @@
+#ifndef HAMMING_INTERLEAVE_H_
+#define HAMMING_INTERLEAVE_H_
+
+#include "hamming.h"
+
+#include <stddef.h>
+
+//Bit interleaving of groups of encoded words, so that a burst error
+//of up to groupSize adjacent bits in the interleaved stream becomes
+//single-bit errors in distinct words.  Word i of an interleaved group
+//holds bit i*64/groupSize ... of each word of the group: for
+//groupSize 64, the group is transposed as a 64x64 bit matrix.
+
+/** Supported group sizes */
+enum {
+  HAMMING_INTERLEAVE_SMALL = 8,
+  HAMMING_INTERLEAVE_LARGE = 64
+};
+
+/** Interleave each complete group of groupSize (one of the above)
+ *  words in words[0 ... n) in place; words after the last complete
+ *  group are left unchanged.
+ */
+void hamming_interleave(HammingWord words[], size_t n, unsigned groupSize);
+
+/** Inverse of hamming_interleave() */
+void hamming_deinterleave(HammingWord words[], size_t n, unsigned groupSize);
+
+#endif //ifndef HAMMING_INTERLEAVE_H_
@@ -0,0 +1,28 @@
+#ifndef HAMMING_MASKS_H_
+#define HAMMING_MASKS_H_
+
+#include "hamming.h"
+
+//Constant masks for the fast encoders and decoders, which support up
+//to 6 parity bits (a 64-bit HammingWord).  Include only from .c files:
+//each includer gets its own static copy.
+
+/** PARITY_GROUP_MASKS[k] has bit bitIndex - 1 set iff bit k of
+ *  bitIndex is 1: the bits covered by the parity bit at 2**k,
+ *  including the parity bit itself.
+ */
+static const HammingWord PARITY_GROUP_MASKS[] = {
+  0x5555555555555555ULL,
+  0x6666666666666666ULL,
+  0x7878787878787878ULL,
+  0x7F807F807F807F80ULL,
+  0x7FFF80007FFF8000ULL,
+  0x7FFFFFFF80000000ULL,
+};
+
+/** PARITY_POSITION_MASKS[n] has a 1 at each of the n parity bits */
+static const HammingWord PARITY_POSITION_MASKS[] = {
+  0x0ULL, 0x1ULL, 0x3ULL, 0xBULL, 0x8BULL, 0x808BULL, 0x8000808BULL,
+};
+
+#endif //ifndef HAMMING_MASKS_H_
@@ -0,0 +1,462 @@
+#include "hamming.h"
+#include "hamming-batch.h"
+#include "hamming-block.h"
+#include "hamming-interleave.h"
+
+#include <check.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//Every valid nParityBits is checked exhaustively: each fast path must
+//return exactly what the reference hamming_encode()/hamming_decode()
+//does for every test word and every single-bit error, and every
+//single-bit error within the 2**nParityBits - 1 bits of the code must
+//be corrected.
+
+enum {
+  MAX_PARITY_BITS = 6,        //largest code which fits a HammingWord
+  N_RANDOM_WORDS = 64,        //random words per nParityBits
+
+  //edge cases (0, all 1's, 2 alternating patterns) + each single bit
+  MAX_TEST_WORDS = 4 + 64 + N_RANDOM_WORDS
+};
+
+/** Return a 64-bit pseudo-random number (xorshift64) */
+static unsigned long long
+random64(void)
+{
+  static unsigned long long state = 0x2545F4914F6CDD1DULL;
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+/** Fill words[] with data words of nDataBits bits: edge cases, each
+ *  single bit and random words.  Return the # of words.
+ */
+static int
+make_test_words(unsigned nDataBits, HammingWord words[MAX_TEST_WORDS])
+{
+  const HammingWord mask = (nDataBits < 64) ? (1ULL << nDataBits) - 1 : ~0ULL;
+  int n = 0;
+  words[n++] = 0;
+  words[n++] = mask;
+  words[n++] = 0x5555555555555555ULL & mask;
+  words[n++] = 0xAAAAAAAAAAAAAAAAULL & mask;
+  for (unsigned i = 0; i < nDataBits; i++) words[n++] = 1ULL << i;
+  for (int i = 0; i < N_RANDOM_WORDS; i++) words[n++] = random64() & mask;
+  return n;
+}
+
+/** Return the bitIndex'th bit (1 ... 64) of word flipped */
+static HammingWord
+flip(HammingWord word, unsigned bitIndex)
+{
+  return word ^ (1ULL << (bitIndex - 1));
+}
+
+/*************************** Plain Encoding ****************************/
+
+START_TEST(encode_fast_reference)
+{
+  HammingWord words[MAX_TEST_WORDS];
+  for (unsigned p = 1; p <= MAX_PARITY_BITS; p++) {
+    const int n = make_test_words(64 - p, words);
+    for (int i = 0; i < n; i++) {
+      const HammingWord expected = hamming_encode(words[i], p);
+      const HammingWord encoded = hamming_encode_fast(words[i], p);
+      ck_assert_msg(encoded == expected,
+                    "p=%u data=0x%llx: fast 0x%llx != reference 0x%llx",
+                    p, words[i], encoded, expected);
+    }
+  }
+}
+END_TEST
+
+START_TEST(encode_n_reference)
+{
+  HammingWord words[MAX_TEST_WORDS];
+  HammingWord encoded[MAX_TEST_WORDS];
+  for (unsigned p = 1; p <= MAX_PARITY_BITS; p++) {
+    const int n = make_test_words(64 - p, words);
+    hamming_encode_n(words, encoded, n, p);
+    for (int i = 0; i < n; i++) {
+      const HammingWord expected = hamming_encode(words[i], p);
+      ck_assert_msg(encoded[i] == expected,
+                    "p=%u data=0x%llx: batch 0x%llx != reference 0x%llx",
+                    p, words[i], encoded[i], expected);
+    }
+  }
+}
+END_TEST
+
+__attribute__((unused))
+static void
+add_encode_tests(Suite *suite)
+{
+  TCase *encode = tcase_create("encode");
+  tcase_add_test(encode, encode_fast_reference);
+  tcase_add_test(encode, encode_n_reference);
+  suite_add_tcase(suite, encode);
+}
+
+/*************************** Plain Decoding ****************************/
+
+/** Check that the reference, fast and batch decoders agree on
+ *  encoded: all return data with no error if isCorrectable.
+ */
+static void
+check_decoders(HammingWord encoded, unsigned p, HammingWord data,
+               int isCorrectable)
+{
+  int refError = 0;
+  const HammingWord ref = hamming_decode(encoded, p, &refError);
+  int fastError = 0;
+  const HammingWord fast = hamming_decode_fast(encoded, p, &fastError);
+  HammingWord batch;
+  const size_t nBatchErrors = hamming_decode_n(&encoded, &batch, 1, p, NULL);
+  ck_assert_msg(fast == ref && !fastError == !refError,
+                "p=%u encoded=0x%llx: fast 0x%llx/%d != reference 0x%llx/%d",
+                p, encoded, fast, fastError, ref, refError);
+  ck_assert_msg(batch == ref && (nBatchErrors != 0) == (refError != 0),
+                "p=%u encoded=0x%llx: batch 0x%llx/%zu != reference 0x%llx/%d",
+                p, encoded, batch, nBatchErrors, ref, refError);
+  if (isCorrectable) {
+    ck_assert_msg(ref == data, "p=%u encoded=0x%llx: decoded 0x%llx != 0x%llx",
+                  p, encoded, ref, data);
+  }
+}
+
+START_TEST(decode_no_error)
+{
+  HammingWord words[MAX_TEST_WORDS];
+  for (unsigned p = 1; p <= MAX_PARITY_BITS; p++) {
+    const int n = make_test_words(64 - p, words);
+    for (int i = 0; i < n; i++) {
+      const HammingWord encoded = hamming_encode(words[i], p);
+      int hasError = 0;
+      hamming_decode_fast(encoded, p, &hasError);
+      ck_assert_msg(!hasError, "p=%u data=0x%llx: spurious error",
+                    p, words[i]);
+      check_decoders(encoded, p, words[i], 1);
+    }
+  }
+}
+END_TEST
+
+/** Every single-bit error in every bit position: errors within the
+ *  2**p - 1 bits of the code are corrected, errors in higher bits
+ *  (which alias code positions) need only match the reference.
+ */
+START_TEST(decode_single_errors)
+{
+  HammingWord words[MAX_TEST_WORDS];
+  for (unsigned p = 1; p <= MAX_PARITY_BITS; p++) {
+    const unsigned nCodeBits = (1u << p) - 1;
+    const int n = make_test_words(64 - p, words);
+    for (int i = 0; i < n; i++) {
+      const HammingWord encoded = hamming_encode(words[i], p);
+      for (unsigned bitIndex = 1; bitIndex <= 64; bitIndex++) {
+        check_decoders(flip(encoded, bitIndex), p, words[i],
+                       bitIndex <= nCodeBits);
+      }
+    }
+  }
+}
+END_TEST
+
+/** The batch decoder over a whole array with an error in every other
+ *  word, so that the SIMD kernels and the scalar tail both see errors.
+ */
+START_TEST(decode_n_errors)
+{
+  HammingWord words[MAX_TEST_WORDS];
+  HammingWord encoded[MAX_TEST_WORDS];
+  HammingWord decoded[MAX_TEST_WORDS];
+  unsigned long long errors[HAMMING_N_ERROR_WORDS(MAX_TEST_WORDS)];
+  for (unsigned p = 1; p <= MAX_PARITY_BITS; p++) {
+    const unsigned nCodeBits = (1u << p) - 1;
+    const int n = make_test_words(64 - p, words);
+    for (int i = 0; i < n; i++) {
+      encoded[i] = hamming_encode(words[i], p);
+      if (i % 2) encoded[i] = flip(encoded[i], 1 + i % nCodeBits);
+    }
+    const size_t nErrors = hamming_decode_n(encoded, decoded, n, p, errors);
+    ck_assert_msg(nErrors == (size_t)n/2, "p=%u: %zu errors != %d",
+                  p, nErrors, n/2);
+    for (int i = 0; i < n; i++) {
+      ck_assert_msg(decoded[i] == words[i],
+                    "p=%u word %d: decoded 0x%llx != 0x%llx",
+                    p, i, decoded[i], words[i]);
+      ck_assert_msg((int)(errors[i/64] >> (i%64) & 1) == i % 2,
+                    "p=%u word %d: wrong error bit", p, i);
+    }
+  }
+}
+END_TEST
+
+__attribute__((unused))
+static void
+add_decode_tests(Suite *suite)
+{
+  TCase *decode = tcase_create("decode");
+  tcase_add_test(decode, decode_no_error);
+  tcase_add_test(decode, decode_single_errors);
+  tcase_add_test(decode, decode_n_errors);
+  suite_add_tcase(suite, decode);
+}
+
+/******************************* SECDED ********************************/
+
+/** Every single-bit error is corrected and every double-bit error
+ *  detected in the 2**p bits of a SECDED word.
+ */
+START_TEST(secded_errors)
+{
+  HammingWord words[MAX_TEST_WORDS];
+  for (unsigned p = 2; p <= MAX_PARITY_BITS; p++) {
+    const unsigned nWordBits = 1u << p;
+    const int n = make_test_words(nWordBits - 1 - p, words);
+    for (int i = 0; i < n; i++) {
+      const HammingWord encoded = hamming_encode_secded(words[i], p);
+      HammingStatus status;
+      HammingWord decoded = hamming_decode_secded(encoded, p, &status);
+      ck_assert_msg(decoded == words[i] && status == HAMMING_OK,
+                    "p=%u data=0x%llx: decoded 0x%llx status %d",
+                    p, words[i], decoded, status);
+      for (unsigned b1 = 1; b1 <= nWordBits; b1++) {
+        decoded = hamming_decode_secded(flip(encoded, b1), p, &status);
+        ck_assert_msg(decoded == words[i] && status == HAMMING_CORRECTED,
+                      "p=%u data=0x%llx bit %u: decoded 0x%llx status %d",
+                      p, words[i], b1, decoded, status);
+        for (unsigned b2 = b1 + 1; b2 <= nWordBits; b2++) {
+          hamming_decode_secded(flip(flip(encoded, b1), b2), p, &status);
+          ck_assert_msg(status == HAMMING_DOUBLE_ERROR,
+                        "p=%u data=0x%llx bits %u, %u: status %d",
+                        p, words[i], b1, b2, status);
+        }
+      }
+    }
+  }
+}
+END_TEST
+
+__attribute__((unused))
+static void
+add_secded_tests(Suite *suite)
+{
+  TCase *secded = tcase_create("secded");
+  tcase_add_test(secded, secded_errors);
+  suite_add_tcase(suite, secded);
+}
+
+/***************************** Block Codes *****************************/
+
+/** Every single-bit error in random blocks of each block code */
+START_TEST(block_single_errors)
+{
+  const unsigned nParityBits[] = { 7, 8, 12 };
+  for (size_t c = 0; c < sizeof(nParityBits)/sizeof(nParityBits[0]); c++) {
+    HammingBlockCode code;
+    ck_assert(init_hamming_block_code(&code, nParityBits[c]) == 0);
+    HammingLimb *data = calloc(code.nDataLimbs, sizeof(HammingLimb));
+    HammingLimb *decoded = calloc(code.nDataLimbs, sizeof(HammingLimb));
+    HammingLimb *encoded = calloc(code.nLimbs, sizeof(HammingLimb));
+    ck_assert(data && decoded && encoded);
+    const size_t dataBytes = code.nDataLimbs*sizeof(HammingLimb);
+    for (int k = 0; k < 2; k++) {
+      for (size_t j = 0; j < code.nDataLimbs; j++) data[j] = random64();
+      if (code.nDataBits % 64) {
+        data[code.nDataLimbs - 1] &= (1ULL << code.nDataBits % 64) - 1;
+      }
+      hamming_block_encode(&code, data, encoded);
+      int hasError;
+      hamming_block_decode(&code, encoded, decoded, &hasError);
+      ck_assert_msg(!hasError && memcmp(decoded, data, dataBytes) == 0,
+                    "%zu-bit block: bad decode without error", code.nBits);
+      for (size_t i = 1; i <= code.nBits; i++) {
+        encoded[i/64] ^= 1ULL << i%64;
+        hamming_block_decode(&code, encoded, decoded, &hasError);
+        encoded[i/64] ^= 1ULL << i%64;
+        ck_assert_msg(hasError && memcmp(decoded, data, dataBytes) == 0,
+                      "%zu-bit block: error in bit %zu not corrected",
+                      code.nBits, i);
+      }
+    }
+    free(data);
+    free(decoded);
+    free(encoded);
+    free_hamming_block_code(&code);
+  }
+}
+END_TEST
+
+__attribute__((unused))
+static void
+add_block_tests(Suite *suite)
+{
+  TCase *block = tcase_create("block");
+  tcase_add_test(block, block_single_errors);
+  suite_add_tcase(suite, block);
+}
+
+/***************************** Interleaving ****************************/
+
+/** A burst of groupSize bits at every offset of an interleaved group
+ *  is corrected after deinterleaving; words after the last complete
+ *  group are not interleaved.
+ */
+START_TEST(interleave_bursts)
+{
+  enum { P = 6, N = 2*HAMMING_INTERLEAVE_LARGE + 5 };
+  const unsigned groupSizes[] =
+    { HAMMING_INTERLEAVE_SMALL, HAMMING_INTERLEAVE_LARGE };
+  HammingWord words[N], encoded[N], burst[N], decoded[N];
+  for (int i = 0; i < N; i++) words[i] = random64() & ((1ULL << (64 - P)) - 1);
+  hamming_encode_n(words, encoded, N, P);
+  for (int g = 0; g < 2; g++) {
+    const unsigned groupSize = groupSizes[g];
+    HammingWord interleaved[N];
+    memcpy(interleaved, encoded, sizeof(encoded));
+    hamming_interleave(interleaved, N, groupSize);
+    const size_t nGrouped = N/groupSize*groupSize;
+    ck_assert(memcmp(&interleaved[nGrouped], &encoded[nGrouped],
+                     (N - nGrouped)*sizeof(HammingWord)) == 0);
+    memcpy(burst, interleaved, sizeof(burst));
+    hamming_deinterleave(burst, N, groupSize);
+    ck_assert(memcmp(burst, encoded, sizeof(burst)) == 0);
+
+    //bursts within the first group; bit 63 of a plain word is not
+    //covered by the code, so skip bursts which would reach it
+    for (unsigned start = 0; start + groupSize <= groupSize*64; start++) {
+      memcpy(burst, interleaved, sizeof(burst));
+      for (unsigned b = start; b < start + groupSize; b++) {
+        burst[b/64] ^= 1ULL << b%64;
+      }
+      hamming_deinterleave(burst, N, groupSize);
+      int isBit63 = 0;
+      for (unsigned w = 0; w < groupSize; w++) {
+        const HammingWord diff = burst[w] ^ encoded[w];
+        ck_assert_msg((diff & (diff - 1)) == 0,
+                      "group %u: burst at bit %u hits word %u twice",
+                      groupSize, start, w);
+        isBit63 |= diff >> 63;
+      }
+      if (isBit63) continue;
+      hamming_decode_n(burst, decoded, N, P, NULL);
+      ck_assert_msg(memcmp(decoded, words, sizeof(words)) == 0,
+                    "group %u: burst at bit %u not corrected",
+                    groupSize, start);
+    }
+  }
+}
+END_TEST
+
+/** 32-bit SECDED words only use the low half of each interleaved
+ *  word, so a burst in the high half of a group only hits bits above
+ *  the low 2**p of its words: they must decode as if there were no
+ *  error.
+ */
+START_TEST(interleave_secded_padding_bursts)
+{
+  enum { P = 5, N = HAMMING_INTERLEAVE_LARGE };
+  const unsigned groupSizes[] =
+    { HAMMING_INTERLEAVE_SMALL, HAMMING_INTERLEAVE_LARGE };
+  HammingWord words[N], encoded[N], burst[N];
+  for (int i = 0; i < N; i++) {
+    words[i] = random64() & ((1ULL << ((1 << P) - 1 - P)) - 1);
+    encoded[i] = hamming_encode_secded(words[i], P);
+  }
+  for (int g = 0; g < 2; g++) {
+    const unsigned groupSize = groupSizes[g];
+    HammingWord interleaved[N];
+    memcpy(interleaved, encoded, sizeof(encoded));
+    hamming_interleave(interleaved, N, groupSize);
+    for (unsigned start = groupSize*32; start + groupSize <= groupSize*64;
+         start++) {
+      memcpy(burst, interleaved, sizeof(burst));
+      for (unsigned b = start; b < start + groupSize; b++) {
+        burst[b/64] ^= 1ULL << b%64;
+      }
+      hamming_deinterleave(burst, N, groupSize);
+      for (unsigned w = 0; w < N; w++) {
+        ck_assert_msg(((burst[w] ^ encoded[w]) & ((1ULL << (1 << P)) - 1))
+                      == 0,
+                      "group %u: burst at bit %u hits low bits of word %u",
+                      groupSize, start, w);
+        HammingStatus status;
+        HammingWord decoded = hamming_decode_secded(burst[w], P, &status);
+        ck_assert_msg(decoded == words[w] && status == HAMMING_OK,
+                      "group %u: burst at bit %u: word %u decoded 0x%llx "
+                      "status %d", groupSize, start, w, decoded, status);
+      }
+    }
+  }
+}
+END_TEST
+
+__attribute__((unused))
+static void
+add_interleave_tests(Suite *suite)
+{
+  TCase *interleave = tcase_create("interleave");
+  tcase_add_test(interleave, interleave_bursts);
+  tcase_add_test(interleave, interleave_secded_padding_bursts);
+  suite_add_tcase(suite, interleave);
+}
+
+/*********************** Test Suite and Runner *************************/
+
+#define encode_test 0x1
+#define decode_test 0x2
+#define secded_test 0x4
+#define block_test 0x8
+#define interleave_test 0x10
+
+#ifndef TEST
+  #define TEST 0
+#endif
+
+#if TEST == 0
+#undef TEST
+#define TEST \
+  (encode_test | decode_test | secded_test | block_test | interleave_test)
+#endif
+
+static Suite *
+hamming_suite(void)
+{
+  Suite *suite = suite_create("hamming");
+
+  #if TEST & encode_test
+  add_encode_tests(suite);
+  #endif
+  #if TEST & decode_test
+  add_decode_tests(suite);
+  #endif
+  #if TEST & secded_test
+  add_secded_tests(suite);
+  #endif
+  #if TEST & block_test
+  add_block_tests(suite);
+  #endif
+  #if TEST & interleave_test
+  add_interleave_tests(suite);
+  #endif
+
+  return suite;
+}
+
+int
+main(void)
+{
+  Suite *suite = hamming_suite();
+  SRunner *runner = srunner_create(suite);
+  srunner_run_all(runner, CK_NORMAL);
+  int nFail = srunner_ntests_failed(runner);
+  srunner_free(runner);
+  return nFail != 0;
+}
@@ -1,9 +1,14 @@
 #include "hamming.h"
+#include "hamming-masks.h"
 
 #include <assert.h>
 #include <math.h>
 #include <stdio.h>
 
+#ifdef __x86_64__
+  #include <immintrin.h>
+#endif
+
 /**
   All bitIndex'es are numbered starting at the LSB which is given index 1
 
@@ -25,7 +30,7 @@ unsigned
 get_bit(HammingWord word, int bitIndex)
 {
   assert(bitIndex > 0);
-  return (word >> bitIndex - 1) & 1ull;
+  return (word >> (bitIndex - 1)) & 1ull;
 }
 
 /** Return word with bit at bitIndex in word set to bitValue. */
@@ -35,7 +40,7 @@ set_bit(HammingWord word, int bitIndex, unsigned bitValue)
   assert(bitIndex > 0);
   assert(bitValue == 0 || bitValue == 1);
   
-  word ^= (-(HammingWord)bitValue ^ word) & (1ULL << bitIndex-1);
+  word ^= (-(HammingWord)bitValue ^ word) & (1ULL << (bitIndex-1));
   return word;
 }
 
@@ -161,12 +166,14 @@ hamming_decode(HammingWord encoded, unsigned nParityBits, int *hasError)
   // The sum, "wrong parities" is the index of the bit that was corrupted, so we will flip that bit.
   if (wrongParities > 0) 
   {
-    tmp ^= 1ul << wrongParities-1;
+    tmp ^= 1ul << (wrongParities-1);
     encoded = tmp;
   }
   
 
-  // (Step 1) Grab each non-parity bit, and paste it into decoded
+  // (Step 1) Grab each non-parity bit, and paste it into decoded; the
+  // nParityBits high bits of the result are left 0.
+  tmp = 0ull;
   for (int dataIndex = 1, encodedIndex = 1; encodedIndex <= nBits; encodedIndex++)
   {
     if ((encodedIndex & (encodedIndex-1)) == 0 && encodedIndex < (1 << nParityBits)) continue;
@@ -178,3 +185,190 @@ hamming_decode(HammingWord encoded, unsigned nParityBits, int *hasError)
 
   return tmp;
 }
+
+/********************* Fast Encoding and Decoding **********************/
+
+/** Return the syndrome of encoded: the bitIndex of the bit in error,
+ *  or 0 if all nParityBits parities check.  The parity over a group
+ *  including its parity bit is 1 exactly when that parity is wrong.
+ */
+static unsigned
+get_syndrome(HammingWord encoded, unsigned nParityBits)
+{
+  unsigned syndrome = 0;
+  for (unsigned k = 0; k < nParityBits; k++) {
+    syndrome |= __builtin_parityll(encoded & PARITY_GROUP_MASKS[k]) << k;
+  }
+  return syndrome;
+}
+
+/** Return the data bits of word, i.e. the bits not in parityMask,
+ *  packed into its low bits.  Each parity bit (all are in the low 32
+ *  bits) is squeezed out by shifting the bits above it down by 1,
+ *  starting with the highest one.
+ */
+static HammingWord
+extract_data_bits(HammingWord word, HammingWord parityMask)
+{
+  while (parityMask != 0) {
+    const int bit = 63 - __builtin_clzll(parityMask);
+    const HammingWord below = (1ULL << bit) - 1;
+    word = (word & below) | ((word >> 1) & ~below);
+    parityMask &= below;
+  }
+  return word;
+}
+
+/** Return word with a 0 inserted at each of the bits in parityMask
+ *  (all in the low 32 bits), the inverse of extract_data_bits(): the
+ *  bits at and above each parity bit are shifted up by 1, starting
+ *  with the lowest one.  Bits shifted out of the top are lost.
+ */
+static HammingWord
+deposit_data_bits(HammingWord word, HammingWord parityMask)
+{
+  while (parityMask != 0) {
+    const HammingWord below = (parityMask & -parityMask) - 1;
+    word = (word & below) | ((word & ~below) << 1);
+    parityMask &= parityMask - 1;
+  }
+  return word;
+}
+
+#ifdef __x86_64__
+
+/** Same as extract_data_bits() using a single BMI2 pext */
+__attribute__((target("bmi2")))
+static HammingWord
+extract_data_bits_bmi2(HammingWord word, HammingWord parityMask)
+{
+  return _pext_u64(word, ~parityMask);
+}
+
+/** Same as deposit_data_bits() using a single BMI2 pdep */
+__attribute__((target("bmi2")))
+static HammingWord
+deposit_data_bits_bmi2(HammingWord word, HammingWord parityMask)
+{
+  return _pdep_u64(word, ~parityMask);
+}
+
+static int
+has_bmi2(void)
+{
+  static int bmi2 = -1;
+  if (bmi2 < 0) {
+    __builtin_cpu_init();
+    bmi2 = __builtin_cpu_supports("bmi2") != 0;
+  }
+  return bmi2;
+}
+
+#define EXTRACT_DATA_BITS(word, parityMask) \
+  (has_bmi2() ? extract_data_bits_bmi2(word, parityMask) \
+              : extract_data_bits(word, parityMask))
+
+#define DEPOSIT_DATA_BITS(word, parityMask) \
+  (has_bmi2() ? deposit_data_bits_bmi2(word, parityMask) \
+              : deposit_data_bits(word, parityMask))
+
+#else //!__x86_64__
+
+#define EXTRACT_DATA_BITS(word, parityMask) \
+  extract_data_bits(word, parityMask)
+
+#define DEPOSIT_DATA_BITS(word, parityMask) \
+  deposit_data_bits(word, parityMask)
+
+#endif //ifdef __x86_64__
+
+/** Same as hamming_encode(), but deposits the data bits and computes
+ *  the parity bits from precomputed masks in a few word operations.
+ */
+HammingWord
+hamming_encode_fast(HammingWord data, unsigned nParityBits)
+{
+  assert(0 < nParityBits && nParityBits <= 6);
+  // the parity bits are still 0, so each group's parity is the parity
+  // bit's value
+  HammingWord word =
+    DEPOSIT_DATA_BITS(data, PARITY_POSITION_MASKS[nParityBits]);
+  for (unsigned k = 0; k < nParityBits; k++) {
+    word |= (HammingWord)__builtin_parityll(word & PARITY_GROUP_MASKS[k])
+      << ((1 << k) - 1);
+  }
+  return word;
+}
+
+/** Same as hamming_decode(), but computes the syndrome from
+ *  precomputed parity masks and extracts the data bits in a few word
+ *  operations instead of probing bits one at a time.
+ */
+HammingWord
+hamming_decode_fast(HammingWord encoded, unsigned nParityBits, int *hasError)
+{
+  assert(0 < nParityBits && nParityBits <= 6);
+  const unsigned syndrome = get_syndrome(encoded, nParityBits);
+  if (syndrome != 0) {
+    *hasError = 1;
+    encoded ^= 1ULL << (syndrome - 1);
+  }
+  return EXTRACT_DATA_BITS(encoded, PARITY_POSITION_MASKS[nParityBits]);
+}
+
+/***************************** SECDED **********************************/
+
+//A SECDED word with nParityBits parity bits is 2**nParityBits bits
+//long: a Hamming code over bitIndex'es 1 ... 2**nParityBits - 1
+//followed by the overall parity bit, which is in no parity group.
+//Unlike the plain codes, which spread data over all 64 bits, every
+//single-bit error is then corrected and every double-bit error is
+//detected.
+
+/** Return the mask for the overall parity bit of a SECDED word */
+static HammingWord
+get_secded_parity_bit(unsigned nParityBits)
+{
+  return 1ULL << ((1 << nParityBits) - 1);
+}
+
+/** Encode data using nParityBits Hamming code parity bits extended
+ *  with an overall parity bit (SECDED: single error correction,
+ *  double error detection) into the low 2**nParityBits bits of the
+ *  result.  Only the low 2**nParityBits - 1 - nParityBits bits of data
+ *  are encoded.
+ */
+HammingWord
+hamming_encode_secded(HammingWord data, unsigned nParityBits)
+{
+  const HammingWord parityBit = get_secded_parity_bit(nParityBits);
+  HammingWord word = hamming_encode_fast(data, nParityBits) & (parityBit - 1);
+  return word | (__builtin_parityll(word) ? parityBit : 0);
+}
+
+/** Decode a word produced by hamming_encode_secded(), setting *status
+ *  to the outcome; bits above the low 2**nParityBits are ignored.  A
+ *  double-bit error is not corrected: the data bits are then returned
+ *  as they were received.
+ */
+HammingWord
+hamming_decode_secded(HammingWord encoded, unsigned nParityBits,
+                      HammingStatus *status)
+{
+  assert(0 < nParityBits && nParityBits <= 6);
+  // A single error flips the overall parity and gives the syndrome of
+  // its bitIndex (0 for the overall parity bit itself); two errors
+  // leave the overall parity even but give a non-zero syndrome.
+  const HammingWord parityBit = get_secded_parity_bit(nParityBits);
+  encoded &= parityBit | (parityBit - 1);
+  const unsigned syndrome = get_syndrome(encoded, nParityBits);
+  if (__builtin_parityll(encoded)) {
+    *status = HAMMING_CORRECTED;
+    if (syndrome != 0) encoded ^= 1ULL << (syndrome - 1);
+  }
+  else {
+    *status = (syndrome == 0) ? HAMMING_OK : HAMMING_DOUBLE_ERROR;
+  }
+  return EXTRACT_DATA_BITS(encoded & (parityBit - 1),
+                           PARITY_POSITION_MASKS[nParityBits]);
+}
@@ -34,4 +34,39 @@ HammingWord hamming_encode(HammingWord data, unsigned nParityBits);
 HammingWord hamming_decode(HammingWord encoded, unsigned nParityBits,
                            int *hasError);
 
+/** Same as hamming_encode(), but deposits the data bits and computes
+ *  the parity bits from precomputed masks in a few word operations.
+ */
+HammingWord hamming_encode_fast(HammingWord data, unsigned nParityBits);
+
+/** Same as hamming_decode(), but computes the syndrome from
+ *  precomputed parity masks and extracts the data bits in a few word
+ *  operations instead of probing bits one at a time.
+ */
+HammingWord hamming_decode_fast(HammingWord encoded, unsigned nParityBits,
+                                int *hasError);
+
+/** Outcome of decoding a SECDED word */
+typedef enum {
+  HAMMING_OK,              //no error detected
+  HAMMING_CORRECTED,       //a single-bit error was corrected
+  HAMMING_DOUBLE_ERROR     //a double-bit error was detected, not corrected
+} HammingStatus;
+
+/** Encode data using nParityBits Hamming code parity bits extended
+ *  with an overall parity bit (SECDED: single error correction,
+ *  double error detection) into the low 2**nParityBits bits of the
+ *  result.  Only the low 2**nParityBits - 1 - nParityBits bits of data
+ *  are encoded.
+ */
+HammingWord hamming_encode_secded(HammingWord data, unsigned nParityBits);
+
+/** Decode a word produced by hamming_encode_secded(), setting *status
+ *  to the outcome; bits above the low 2**nParityBits are ignored.  A
+ *  double-bit error is not corrected: the data bits are then returned
+ *  as they were received.
+ */
+HammingWord hamming_decode_secded(HammingWord encoded, unsigned nParityBits,
+                                  HammingStatus *status);
+
 #endif //ifndef HAMMING_H_
\ No newline at end of file
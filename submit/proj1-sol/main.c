@@ -1,52 +1,95 @@
 #include "hamming.h"
+#include "hamming-batch.h"
+#include "hamming-interleave.h"
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
+#include <unistd.h>
 
 
+/** Options given on the command line */
+typedef struct {
+  int nParityBits;
+  bool isDecode;          //hamming-decode rather than hamming-encode
+  bool isVerbose;         //-v: decode only
+  bool isSecded;          //-s: SECDED words with an overall parity bit
+  bool isBinary;          //-b: raw 64-bit words instead of text
+  int nThreads;           //-j: # of coding threads for binary mode
+  bool hasThreads;        //-j was given: only valid with -b
+  unsigned groupSize;     //-i: interleaved group size, 0 for none
+} Options;
+
+/** Return the # of bits in a word to be encoded or decoded */
+static int
+get_n_in_bits(const Options *options)
+{
+  if (options->isSecded) {
+    const int nWordBits = 1 << options->nParityBits;
+    return (options->isDecode) ? nWordBits
+                               : nWordBits - 1 - options->nParityBits;
+  }
+  return (options->isDecode) ? 64 : 64 - options->nParityBits;
+}
+
+/** Output SECDED-decoded word z followed by a * if an error was
+ *  corrected, or by a ! if a double-bit error was detected (z then
+ *  contains the uncorrected data bits).  Return non-zero for a double
+ *  error.
+ */
+static int
+out_secded(HammingWord z, HammingStatus status, FILE *out)
+{
+  const char *mark = (status == HAMMING_CORRECTED) ? "*"
+    : (status == HAMMING_DOUBLE_ERROR) ? "!" : "";
+  fprintf(out, "%llu%s\n", z, mark);
+  return status == HAMMING_DOUBLE_ERROR;
+}
+
 /** Read whitespace-separated HammingWord's from stream in.  If
- *  doDecode is non-zero, then hamming-decode them onto stream out;
+ *  options->isDecode, then hamming-decode them onto stream out;
  *  otherwise hamming-encode them on stream out.
  *  If isVerbose (must be isDecode), then output a * after every
  *  corrected output
  */
 static int
-do_hamming(FILE *in, int nParityBits, bool isDecode, bool isVerbose,
-           FILE *out)
+do_hamming(FILE *in, const Options *options, FILE *out)
 {
-  assert(isVerbose ? isDecode : true);
+  const int nParityBits = options->nParityBits;
+  const bool isDecode = options->isDecode;
+  assert(options->isVerbose ? isDecode : true);
   int hasError = 0;  //got an error on any word
-  int nEncodedBits = (1 << nParityBits) - 1;
-  int nInBits = (isDecode) ? nEncodedBits : 64 - nParityBits;
-  //HammingWord maxIn = 
+  const int nInBits = get_n_in_bits(options);
   HammingWord v = 0ull;
 
-  //printf("(debug) maxIn=%lld nParityBits=%d inputWord=", maxIn, nParityBits);
-  
-
   while (fscanf(in, "%llu", &v) == 1){
-    if (log2(v) > 64-nParityBits) {
+    if (nInBits < 64 && (v >> nInBits) != 0) {
       fprintf(stderr, "value %llu does not fit in %d bits\n", v, nInBits);
       hasError = 1;
       break;
     }
-    if (isDecode) {
+    if (isDecode && options->isSecded) {
+      HammingStatus status;
+      HammingWord z = hamming_decode_secded(v, nParityBits, &status);
+      hasError |= out_secded(z, status, out);
+    }
+    else if (isDecode) {
       int isError = 0;  //for error in this word
-      HammingWord z = hamming_decode(v, nParityBits, &isError);
+      HammingWord z = hamming_decode_fast(v, nParityBits, &isError);
       if (hasError || isError) fprintf(out, "%llu*\n", z); else fprintf(out, "%llu\n", z);
-
-      /*hasError = hasError || isError;
-      const char *errStr = (isVerbose && isError) ? "*" : "";
-      fprintf(out, "%llu%s\n", z, errStr);*/
+    }
+    else if (options->isSecded) {
+      fprintf(out, "%llu\n", hamming_encode_secded(v, nParityBits));
     }
     else {
-      fprintf(out, "%llu\n", hamming_encode(v, nParityBits));
+      fprintf(out, "%llu\n", hamming_encode_fast(v, nParityBits));
     }
     fflush(out);
   }
@@ -54,13 +97,387 @@ do_hamming(FILE *in, int nParityBits, bool isDecode, bool isVerbose,
 }
 
 
+/************************** Binary Streaming ***************************/
+
+enum {
+  //# of words per read() and write() in binary mode; a multiple of
+  //every interleaved group size, so groups never straddle blocks
+  BLOCK_WORDS = 1 << 16
+};
+
+/** Errors found while decoding */
+typedef struct {
+  size_t nCorrected;          //words with a corrected error
+  size_t nDoubleErrors;       //SECDED words with a double-bit error
+} ErrorCounts;
+
+/** Encode or decode the n words in[] into out[] as specified by
+ *  options, adding the errors found to counts.  With
+ *  options->groupSize, encoded words are interleaved in out[] and
+ *  deinterleaved in place in in[] before decoding.  When encoding,
+ *  return non-zero without coding anything if some word in[] has more
+ *  than get_n_in_bits() significant bits.  Words being decoded are
+ *  never rejected: a SECDED word with p < 6 parity bits is just masked
+ *  to its low 2**p bits, since any bit set above them is itself a
+ *  corruption of the stream.
+ */
+static int
+code_block(const Options *options, HammingWord *in, HammingWord *out,
+           size_t n, ErrorCounts *counts)
+{
+  if (options->groupSize && options->isDecode) {
+    hamming_deinterleave(in, n, options->groupSize);
+  }
+  if (!options->isDecode) {
+    // a word fits iff it has enough leading 0 bits: check them all at once
+    const int nInBits = get_n_in_bits(options);
+    HammingWord bits = 0;
+    for (size_t i = 0; i < n; i++) bits |= in[i];
+    if (bits != 0 && 64 - __builtin_clzll(bits) > nInBits) return 1;
+  }
+
+  const int nParityBits = options->nParityBits;
+  if (options->isSecded && options->isDecode) {
+    // hamming_decode_secded() ignores the bits above the low 2**p
+    for (size_t i = 0; i < n; i++) {
+      HammingStatus status;
+      out[i] = hamming_decode_secded(in[i], nParityBits, &status);
+      counts->nCorrected += (status == HAMMING_CORRECTED);
+      counts->nDoubleErrors += (status == HAMMING_DOUBLE_ERROR);
+    }
+  }
+  else if (options->isSecded) {
+    for (size_t i = 0; i < n; i++) {
+      out[i] = hamming_encode_secded(in[i], nParityBits);
+    }
+  }
+  else if (options->isDecode) {
+    counts->nCorrected += hamming_decode_n(in, out, n, nParityBits, NULL);
+  }
+  else {
+    hamming_encode_n(in, out, n, nParityBits);
+  }
+  if (options->groupSize && !options->isDecode) {
+    hamming_interleave(out, n, options->groupSize);
+  }
+  return 0;
+}
+
+/** Read up to n bytes from fd into buf, stopping early only at EOF.
+ *  Return the # of bytes read, -1 on error.
+ */
+static ssize_t
+read_fully(int fd, void *buf, size_t n)
+{
+  size_t nRead = 0;
+  while (nRead < n) {
+    ssize_t nBytes = read(fd, (char *)buf + nRead, n - nRead);
+    if (nBytes < 0 && errno == EINTR) continue;
+    if (nBytes < 0) return -1;
+    if (nBytes == 0) break;
+    nRead += nBytes;
+  }
+  return nRead;
+}
+
+/** Write all n bytes of buf to fd.  Return 0, -1 on error. */
+static int
+write_fully(int fd, const void *buf, size_t n)
+{
+  size_t nWritten = 0;
+  while (nWritten < n) {
+    ssize_t nBytes = write(fd, (const char *)buf + nWritten, n - nWritten);
+    if (nBytes < 0 && errno == EINTR) continue;
+    if (nBytes < 0) return -1;
+    nWritten += nBytes;
+  }
+  return 0;
+}
+
+/** Report counts on stderr when decoding, if there were any errors or
+ *  options->isVerbose.  Return non-zero iff there was a double-bit
+ *  error.
+ */
+static int
+report_errors(const Options *options, const ErrorCounts *counts)
+{
+  if (!options->isDecode) return 0;
+  if (options->isVerbose || counts->nCorrected > 0) {
+    fprintf(stderr, "%zu words corrected\n", counts->nCorrected);
+  }
+  if (counts->nDoubleErrors > 0) {
+    fprintf(stderr, "%zu words with uncorrectable double-bit errors\n",
+            counts->nDoubleErrors);
+  }
+  return counts->nDoubleErrors > 0;
+}
+
+/** Same as do_hamming() but with input and output consisting of raw
+ *  native-endian 64-bit words, coded BLOCK_WORDS at a time with the
+ *  batch API.  Decoding errors are reported on stderr at the end.
+ */
+static int
+do_hamming_binary(int inFd, const Options *options, int outFd)
+{
+  HammingWord *in = malloc(BLOCK_WORDS * sizeof(HammingWord));
+  HammingWord *out = malloc(BLOCK_WORDS * sizeof(HammingWord));
+  if (!in || !out) {
+    fprintf(stderr, "cannot allocate buffers: %s\n", strerror(errno));
+    exit(1);
+  }
+  ErrorCounts counts = { 0 };
+  int hasError = 0;
+  for (;;) {
+    ssize_t nBytes = read_fully(inFd, in, BLOCK_WORDS * sizeof(HammingWord));
+    if (nBytes < 0) {
+      fprintf(stderr, "read error: %s\n", strerror(errno));
+      hasError = 1;
+      break;
+    }
+    if (nBytes % sizeof(HammingWord) != 0) {
+      fprintf(stderr, "input is not a whole # of %zu-byte words\n",
+              sizeof(HammingWord));
+      hasError = 1;
+      break;
+    }
+    const size_t n = nBytes / sizeof(HammingWord);
+    if (n == 0) break;
+    if (code_block(options, in, out, n, &counts) != 0) {
+      fprintf(stderr, "input word does not fit in %d bits\n",
+              get_n_in_bits(options));
+      hasError = 1;
+      break;
+    }
+    if (write_fully(outFd, out, n * sizeof(HammingWord)) != 0) {
+      fprintf(stderr, "write error: %s\n", strerror(errno));
+      hasError = 1;
+      break;
+    }
+  }
+  free(in);
+  free(out);
+  return report_errors(options, &counts) || hasError;
+}
+
+
+/************************ Multithreaded Binary *************************/
+
+//With -j, chunks of BLOCK_WORDS words are read in order into a ring
+//of slots which doubles as the reorder buffer: worker threads code
+//the slots in the order they were read, possibly finishing out of
+//order, while the main thread writes each slot in sequence once it is
+//coded and then refills it with the next chunk.
+
+typedef enum { SLOT_FREE, SLOT_READ, SLOT_CODED } SlotState;
+
+typedef struct {
+  HammingWord *in;
+  HammingWord *out;
+  size_t n;                   //# of words in chunk
+  SlotState state;
+  int isRangeError;           //some word to encode in in[] did not fit
+  ErrorCounts counts;
+} Slot;
+
+typedef struct {
+  const Options *options;
+  Slot *slots;
+  size_t nSlots;
+  size_t nRead;               //# of chunks read so far
+  size_t nTaken;              //# of chunks taken by workers
+  bool isDone;                //no more chunks will be read
+  pthread_mutex_t lock;
+  pthread_cond_t isReadable;  //signalled when a chunk is read or isDone
+  pthread_cond_t isCoded;     //signalled when a chunk is coded
+} Pool;
+
+/** Worker thread: code chunks in read order until the pool is done */
+static void *
+code_chunks(void *arg)
+{
+  Pool *pool = arg;
+  pthread_mutex_lock(&pool->lock);
+  for (;;) {
+    while (pool->nTaken == pool->nRead && !pool->isDone) {
+      pthread_cond_wait(&pool->isReadable, &pool->lock);
+    }
+    if (pool->nTaken == pool->nRead) break;
+    Slot *slot = &pool->slots[pool->nTaken++ % pool->nSlots];
+    pthread_mutex_unlock(&pool->lock);
+
+    slot->counts = (ErrorCounts){ 0 };
+    slot->isRangeError =
+      code_block(pool->options, slot->in, slot->out, slot->n, &slot->counts);
+
+    pthread_mutex_lock(&pool->lock);
+    slot->state = SLOT_CODED;
+    pthread_cond_broadcast(&pool->isCoded);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+/** Return a pool with 2 slots per thread; exits on allocation failure */
+static Pool *
+new_pool(const Options *options)
+{
+  Pool *pool = calloc(1, sizeof(Pool));
+  const size_t nSlots = 2 * options->nThreads;
+  Slot *slots = calloc(nSlots, sizeof(Slot));
+  if (!pool || !slots) {
+    fprintf(stderr, "cannot allocate %zu slots\n", nSlots);
+    exit(1);
+  }
+  for (size_t i = 0; i < nSlots; i++) {
+    slots[i].in = malloc(BLOCK_WORDS * sizeof(HammingWord));
+    slots[i].out = malloc(BLOCK_WORDS * sizeof(HammingWord));
+    if (!slots[i].in || !slots[i].out) {
+      fprintf(stderr, "cannot allocate buffers: %s\n", strerror(errno));
+      exit(1);
+    }
+  }
+  *pool = (Pool) {
+    .options = options,
+    .slots = slots,
+    .nSlots = nSlots,
+  };
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->isReadable, NULL);
+  pthread_cond_init(&pool->isCoded, NULL);
+  return pool;
+}
+
+static void
+free_pool(Pool *pool)
+{
+  for (size_t i = 0; i < pool->nSlots; i++) {
+    free(pool->slots[i].in);
+    free(pool->slots[i].out);
+  }
+  free(pool->slots);
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->isReadable);
+  pthread_cond_destroy(&pool->isCoded);
+  free(pool);
+}
+
+/** Read the next chunk into its free slot.  Return 1 if a chunk was
+ *  read, 0 at EOF, -1 after reporting an error.
+ */
+static int
+read_chunk(int inFd, Pool *pool)
+{
+  Slot *slot = &pool->slots[pool->nRead % pool->nSlots];
+  assert(slot->state == SLOT_FREE);
+  ssize_t nBytes =
+    read_fully(inFd, slot->in, BLOCK_WORDS * sizeof(HammingWord));
+  if (nBytes < 0) {
+    fprintf(stderr, "read error: %s\n", strerror(errno));
+    return -1;
+  }
+  if (nBytes % sizeof(HammingWord) != 0) {
+    fprintf(stderr, "input is not a whole # of %zu-byte words\n",
+            sizeof(HammingWord));
+    return -1;
+  }
+  slot->n = nBytes / sizeof(HammingWord);
+  if (slot->n == 0) return 0;
+  pthread_mutex_lock(&pool->lock);
+  slot->state = SLOT_READ;
+  pool->nRead++;
+  pthread_cond_signal(&pool->isReadable);
+  pthread_mutex_unlock(&pool->lock);
+  return 1;
+}
+
+/** Same as do_hamming_binary(), but coding chunks on
+ *  options->nThreads threads; error counts from all chunks are
+ *  reported together at the end.
+ */
+static int
+do_hamming_threads(int inFd, const Options *options, int outFd)
+{
+  Pool *pool = new_pool(options);
+  pthread_t *threads = calloc(options->nThreads, sizeof(pthread_t));
+  if (!threads) {
+    fprintf(stderr, "cannot allocate %d threads\n", options->nThreads);
+    exit(1);
+  }
+  int nStarted = 0;
+  for (; nStarted < options->nThreads; nStarted++) {
+    if (pthread_create(&threads[nStarted], NULL, code_chunks, pool) != 0) break;
+  }
+  if (nStarted == 0) {
+    fprintf(stderr, "cannot create threads\n");
+    exit(1);
+  }
+
+  ErrorCounts counts = { 0 };
+  int hasError = 0;
+  bool isEof = false;
+  for (size_t nWritten = 0; !hasError; nWritten++) {
+    // keep every slot busy, then wait for the oldest chunk
+    while (!isEof && pool->nRead - nWritten < pool->nSlots) {
+      int status = read_chunk(inFd, pool);
+      if (status < 0) hasError = 1;
+      isEof = status <= 0;
+    }
+    if (nWritten == pool->nRead) break;
+    Slot *slot = &pool->slots[nWritten % pool->nSlots];
+    pthread_mutex_lock(&pool->lock);
+    while (slot->state != SLOT_CODED) {
+      pthread_cond_wait(&pool->isCoded, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if (slot->isRangeError) {
+      fprintf(stderr, "input word does not fit in %d bits\n",
+              get_n_in_bits(options));
+      hasError = 1;
+    }
+    else if (write_fully(outFd, slot->out, slot->n * sizeof(HammingWord))) {
+      fprintf(stderr, "write error: %s\n", strerror(errno));
+      hasError = 1;
+    }
+    counts.nCorrected += slot->counts.nCorrected;
+    counts.nDoubleErrors += slot->counts.nDoubleErrors;
+    slot->state = SLOT_FREE;
+  }
+
+  // workers finish any chunks already read, then exit
+  pthread_mutex_lock(&pool->lock);
+  pool->isDone = true;
+  pthread_cond_broadcast(&pool->isReadable);
+  pthread_mutex_unlock(&pool->lock);
+  for (int i = 0; i < nStarted; i++) pthread_join(threads[i], NULL);
+  free(threads);
+  free_pool(pool);
+  return report_errors(options, &counts) || hasError;
+}
+
+
 static void
 usage(void)
 {
   fprintf(stderr,
-          "usage:\thamming-encode N_HAMMING_PARITY_BITS [IN_FILE_NAME]\n");
+          "usage:\thamming-encode [-s] [-b [-j N_THREADS] [-i 8|64]] "
+          "N_HAMMING_PARITY_BITS "
+          "[IN_FILE_NAME]\n");
+  fprintf(stderr,
+          "\thamming-decode [-v] [-s] [-b [-j N_THREADS] [-i 8|64]] "
+          "N_HAMMING_PARITY_BITS "
+          "[IN_FILE_NAME]\n");
   fprintf(stderr,
-          "\thamming-decode [-v] N_HAMMING_PARITY_BITS [IN_FILE_NAME]\n");
+          "  -s: SECDED words of 2**N_HAMMING_PARITY_BITS bits with an "
+          "overall parity bit;\n"
+          "      decoding marks double-bit errors with a !\n"
+          "  -b: read and write raw native-endian 64-bit words; decoding\n"
+          "      reports the # of corrected words on stderr\n"
+          "  -j N_THREADS: with -b, code chunks of the input on N_THREADS "
+          "threads\n"
+          "  -i 8|64: with -b, bit-interleave each group of 8 or 64 "
+          "encoded words\n"
+          "      so that bursts of up to that many bits are correctable\n");
   exit(1);
 }
 
@@ -73,42 +490,76 @@ main(int argc, const char *argv[])
   // does checking and conversion of args;
   // all actual work relegated to do_hamming()
 
-  if (argc == 1) usage();
-  const char *parityBitsArg = (argc >= 2) ? argv[1] : NULL;
-  bool isDecode = strstr(argv[0], "decode") != NULL;
-  bool isVerbose = false;
-  if (isDecode) {
-    isVerbose = strcmp(argv[1], "-v") == 0;
-    int maxNArgs = (isVerbose) ? 4 : 3;
-    if (argc > maxNArgs) usage();
-    if (isVerbose) parityBitsArg = argv[2];
+  Options options = {
+    .isDecode = strstr(argv[0], "decode") != NULL,
+    .nThreads = 1,
+  };
+  int argIndex = 1;
+  for (; argIndex < argc && argv[argIndex][0] == '-'; argIndex++) {
+    if (options.isDecode && strcmp(argv[argIndex], "-v") == 0) {
+      options.isVerbose = true;
+    }
+    else if (strcmp(argv[argIndex], "-s") == 0) {
+      options.isSecded = true;
+    }
+    else if (strcmp(argv[argIndex], "-b") == 0) {
+      options.isBinary = true;
+    }
+    else if (strcmp(argv[argIndex], "-j") == 0 && argIndex + 1 < argc) {
+      options.nThreads = atoi(argv[++argIndex]);
+      if (options.nThreads <= 0) usage();
+      options.hasThreads = true;
+    }
+    else if (strcmp(argv[argIndex], "-i") == 0 && argIndex + 1 < argc) {
+      options.groupSize = atoi(argv[++argIndex]);
+      if (options.groupSize != HAMMING_INTERLEAVE_SMALL &&
+          options.groupSize != HAMMING_INTERLEAVE_LARGE) {
+        usage();
+      }
+    }
+    else {
+      usage();
+    }
   }
-  else {
-    if (argc > 3) usage();
+  if (argIndex == argc || argc - argIndex > 2) usage();
+  if ((options.hasThreads || options.groupSize) && !options.isBinary) {
+    usage();
   }
+  const char *parityBitsArg = argv[argIndex];
 
-  int nParityBits = atoi(parityBitsArg);
-  if (nParityBits <= 0) {
+  options.nParityBits = atoi(parityBitsArg);
+  if (options.nParityBits <= 0) {
     fprintf(stderr, "N_HAMMING_PARITY_BITS \"%s\" not a positive integer\n",
-            argv[0]);
+            parityBitsArg);
     exit(1);
   }
   unsigned nHammingWordBits = sizeof(HammingWord) * CHAR_BIT;
-  if ((1ULL << nParityBits) - 1 > nHammingWordBits) {
+  if (options.nParityBits >= nHammingWordBits ||
+      (1ULL << options.nParityBits) - 1 > nHammingWordBits) {
     fprintf(stderr, "total Hamming word bit-length must be a positive integer "
             "<= %u\n", nHammingWordBits);
     exit(1);
   }
 
-  const int inFileNameIndex = (isVerbose) ? 3 : 2;
+  const int inFileNameIndex = argIndex + 1;
   const char *inFileName =
     (inFileNameIndex < argc) ? argv[inFileNameIndex] : NULL;
+  if (options.isBinary) {
+    int inFd = (inFileName) ? open(inFileName, O_RDONLY) : STDIN_FILENO;
+    if (inFd < 0) {
+      fprintf(stderr, "cannot read '%s': %s\n", inFileName, strerror(errno));
+      return 1;
+    }
+    return (options.nThreads > 1)
+      ? do_hamming_threads(inFd, &options, STDOUT_FILENO)
+      : do_hamming_binary(inFd, &options, STDOUT_FILENO);
+  }
+
   FILE *in = (inFileName) ? fopen(inFileName, "r") : stdin;
   if (!in) {
     fprintf(stderr, "cannot read '%s': %s\n", inFileName, strerror(errno));
     return 1;
   }
 
-  return do_hamming(in, nParityBits, isDecode, isVerbose, stdout);
+  return do_hamming(in, &options, stdout);
 }
-
@@ -0,0 +1,205 @@
+
+
+//Vector kernels for bcd-batch.c.  This file is included once per
+//instruction set with BCD_SIMD(name) giving the name used for each
+//function and BCD_SIMD_LANES the # of 64-bit lanes in a vector; it
+//uses GCC vector extensions so the same source serves every target.
+//
+//Each Bcd or Binary is widened into a 64-bit lane, so a single set of
+//SWAR constants serves every BCD_BASE.  Each kernel handles the
+//largest multiple of BCD_SIMD_LANES elements <= n, returns that
+//count and leaves the remaining elements to the caller.  Errors are
+//computed branch-free as a vector of BcdError codes.
+
+#define Vec BCD_SIMD(Vec)
+#define BcdVec BCD_SIMD(BcdVec)
+
+typedef unsigned long long Vec
+  __attribute__((vector_size(8*BCD_SIMD_LANES)));
+typedef Bcd BcdVec
+  __attribute__((vector_size(sizeof(Bcd)*BCD_SIMD_LANES)));
+
+static inline Vec
+BCD_SIMD(load)(const Bcd *p)
+{
+  BcdVec b;
+  memcpy(&b, p, sizeof(b));
+  return __builtin_convertvector(b, Vec);
+}
+
+static inline void
+BCD_SIMD(store)(Bcd *p, Vec v)
+{
+  BcdVec b = __builtin_convertvector(v, BcdVec);
+  memcpy(p, &b, sizeof(b));
+}
+
+/** Set errs[] from err lanes if errs is not NULL, return lanes of
+ *  BCD_ERR_BIT(err).
+ */
+static inline Vec
+BCD_SIMD(report)(Vec err, BcdError *errs)
+{
+  if (errs) {
+    for (int k = 0; k < BCD_SIMD_LANES; k++) errs[k] = err[k];
+  }
+  return ((Vec){ 0 } + 1) << err;
+}
+
+/** Reduce the lanes of seen to a batch summary */
+static inline unsigned
+BCD_SIMD(summary)(Vec seen)
+{
+  unsigned summary = 0;
+  for (int k = 0; k < BCD_SIMD_LANES; k++) summary |= seen[k];
+  return summary & ~BCD_ERR_BIT(OK_ERR);
+}
+
+/** All-ones in lanes of x which contain a BCD digit > 9 */
+static inline Vec
+BCD_SIMD(bad_digits)(Vec x)
+{
+  return (Vec)(((x >> 3) & ((x >> 2) | (x >> 1)) & BCD_SWAR_ONES) != 0);
+}
+
+/** Packed BCD for v < 10**8 in each lane: split into fields of 4, 2
+ *  and then 1 digit(s) with multiplications by scaled reciprocals,
+ *  then squeeze the resulting digit bytes into nybbles.
+ */
+static inline Vec
+BCD_SIMD(bcd8_from_binary)(Vec v)
+{
+  Vec q = (v * 109951163) >> 40;                           // v / 10**4
+  Vec m = (v - q*10000) | q << 32;
+  q = ((m * 10486) >> 20) & 0x0000007F0000007FULL;         // / 100
+  m = (m - q*100) | q << 16;
+  q = ((m * 103) >> 10) & 0x000F000F000F000FULL;           // / 10
+  m = (m - q*10) | q << 8;
+  m = (m | m >> 4) & 0x00FF00FF00FF00FFULL;
+  m = (m | m >> 8) & 0x0000FFFF0000FFFFULL;
+  return (m | m >> 16) & 0xFFFFFFFFULL;
+}
+
+/** Packed BCD for v <= BCD_MAX_BINARY in each lane */
+static inline Vec
+BCD_SIMD(from_binary)(Vec v)
+{
+  if (sizeof(Bcd) <= 4) return BCD_SIMD(bcd8_from_binary)(v);
+  // q = v / 10**8 to within 1 using 2**60/10**8; then correct it
+  Vec q = ((v >> 24) * 11529215046ULL) >> 36;
+  Vec r = v - q*100000000;
+  Vec fix = (Vec)(r >= 100000000);
+  q -= fix;
+  r -= fix & 100000000;
+  return BCD_SIMD(bcd8_from_binary)(r) | BCD_SIMD(bcd8_from_binary)(q) << 32;
+}
+
+/** Binary value of valid packed BCD x in each lane: combine pairs of
+ *  digits, then pairs of 2-digit and 4-digit fields.
+ */
+static inline Vec
+BCD_SIMD(to_binary)(Vec x)
+{
+  x = (x & 0x0F0F0F0F0F0F0F0FULL) + ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL)*10;
+  x = (x & 0x00FF00FF00FF00FFULL) + ((x >> 8) & 0x00FF00FF00FF00FFULL)*100;
+  x = (x & 0x0000FFFF0000FFFFULL) +
+    ((x >> 16) & 0x0000FFFF0000FFFFULL)*10000;
+  return (x & 0xFFFFFFFFULL) + (x >> 32)*100000000;
+}
+
+static size_t
+BCD_SIMD(binary_to_bcd_n)(const Binary *in, Bcd *out, size_t n,
+                          BcdError *errs, unsigned *summary)
+{
+  Vec seen = { 0 };
+  size_t i;
+  for (i = 0; i + BCD_SIMD_LANES <= n; i += BCD_SIMD_LANES) {
+    Vec v = BCD_SIMD(load)(in + i);
+    Vec ovf = (Vec)(v > BCD_MAX_BINARY);
+    BCD_SIMD(store)(out + i, BCD_SIMD(from_binary)(v & ~ovf));
+    seen |= BCD_SIMD(report)(ovf & OVERFLOW_ERR, errs ? errs + i : NULL);
+  }
+  *summary |= BCD_SIMD(summary)(seen);
+  return i;
+}
+
+static size_t
+BCD_SIMD(bcd_to_binary_n)(const Bcd *in, Binary *out, size_t n,
+                          BcdError *errs, unsigned *summary)
+{
+  Vec seen = { 0 };
+  size_t i;
+  for (i = 0; i + BCD_SIMD_LANES <= n; i += BCD_SIMD_LANES) {
+    Vec x = BCD_SIMD(load)(in + i);
+    Vec bad = BCD_SIMD(bad_digits)(x);
+    BCD_SIMD(store)(out + i, BCD_SIMD(to_binary)(x & ~bad));
+    seen |= BCD_SIMD(report)(bad & BAD_VALUE_ERR, errs ? errs + i : NULL);
+  }
+  *summary |= BCD_SIMD(summary)(seen);
+  return i;
+}
+
+static size_t
+BCD_SIMD(bcd_add_n)(const Bcd *x, const Bcd *y, Bcd *out, size_t n,
+                    BcdError *errs, unsigned *summary)
+{
+  Vec seen = { 0 };
+  size_t i;
+  for (i = 0; i + BCD_SIMD_LANES <= n; i += BCD_SIMD_LANES) {
+    Vec a = BCD_SIMD(load)(x + i);
+    Vec b = BCD_SIMD(load)(y + i);
+    Vec bad = BCD_SIMD(bad_digits)(a) | BCD_SIMD(bad_digits)(b);
+    // lane-wise bcd_swar_add(); a narrower Bcd overflows into the zero
+    // digits above it
+    Vec t1 = a + BCD_SWAR_SIXES;
+    Vec sum = t1 + b;
+    Vec carry = (Vec)(sum < t1);
+    Vec noCarry = ~(((sum ^ t1 ^ b) >> 4) | carry << 60) & BCD_SWAR_ONES;
+    sum -= (noCarry << 2) | (noCarry << 1);
+    Vec ovf = carry | (Vec)(sum > (Bcd)~0ULL);
+    BCD_SIMD(store)(out + i, sum & ~(bad | ovf));
+    Vec err = (bad & BAD_VALUE_ERR) | (~bad & ovf & OVERFLOW_ERR);
+    seen |= BCD_SIMD(report)(err, errs ? errs + i : NULL);
+  }
+  *summary |= BCD_SIMD(summary)(seen);
+  return i;
+}
+
+static size_t
+BCD_SIMD(bcd_multiply_n)(const Bcd *x, const Bcd *y, Bcd *out, size_t n,
+                         BcdError *errs, unsigned *summary)
+{
+  Vec seen = { 0 };
+  size_t i;
+  for (i = 0; i + BCD_SIMD_LANES <= n; i += BCD_SIMD_LANES) {
+    Vec a = BCD_SIMD(load)(x + i);
+    Vec b = BCD_SIMD(load)(y + i);
+    Vec bad = BCD_SIMD(bad_digits)(a) | BCD_SIMD(bad_digits)(b);
+    a = BCD_SIMD(to_binary)(a & ~bad);
+    b = BCD_SIMD(to_binary)(b & ~bad);
+    if (sizeof(Bcd) > 4) {
+      // the product of operands >= 2**32 may not fit in a lane
+      Vec big = (a | b) >> 32;
+      int isBig = 0;
+      for (int k = 0; k < BCD_SIMD_LANES; k++) isBig |= big[k] != 0;
+      if (isBig) {
+        for (int k = 0; k < BCD_SIMD_LANES; k++) {
+          BcdError err = OK_ERR;
+          out[i + k] = bcd_multiply(x[i + k], y[i + k], &err);
+          *summary |= note_error(err, errs, i + k);
+        }
+        continue;
+      }
+    }
+    Vec product = a * b;
+    Vec ovf = (Vec)(product > BCD_MAX_BINARY) & ~bad;
+    BCD_SIMD(store)(out + i, BCD_SIMD(from_binary)(product & ~(bad | ovf)));
+    Vec err = (bad & BAD_VALUE_ERR) | (ovf & OVERFLOW_ERR);
+    seen |= BCD_SIMD(report)(err, errs ? errs + i : NULL);
+  }
+  *summary |= BCD_SIMD(summary)(seen);
+  return i;
+}
+
+#undef Vec
+#undef BcdVec
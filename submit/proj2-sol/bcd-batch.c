@@ -0,0 +1,122 @@
+
+
+#include "bcd-batch.h"
+#include "bcd-swar.h"
+
+#include <string.h>
+
+//use the SSE2/AVX2 kernels from bcd-batch-simd.h when non-zero
+#ifndef BCD_BATCH_SIMD
+  #define BCD_BATCH_SIMD 1
+#endif
+
+#if BCD_BATCH_SIMD && !defined(__x86_64__)
+  #undef BCD_BATCH_SIMD
+  #define BCD_BATCH_SIMD 0
+#endif
+
+//the kernels store BcdError lanes into errs[] as int's
+_Static_assert(sizeof(BcdError) == sizeof(int), "BcdError is not an int");
+
+/** Record err for element i, return its contribution to a summary */
+static inline unsigned
+note_error(BcdError err, BcdError *errs, size_t i)
+{
+  if (errs) errs[i] = err;
+  return BCD_ERR_BIT(err) & ~BCD_ERR_BIT(OK_ERR);
+}
+
+#if BCD_BATCH_SIMD
+
+#define BCD_SIMD(name) name##_sse2
+#define BCD_SIMD_LANES 2
+#include "bcd-batch-simd.h"
+#undef BCD_SIMD
+#undef BCD_SIMD_LANES
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#define BCD_SIMD(name) name##_avx2
+#define BCD_SIMD_LANES 4
+#include "bcd-batch-simd.h"
+#undef BCD_SIMD
+#undef BCD_SIMD_LANES
+#pragma GCC pop_options
+
+static int
+has_avx2(void)
+{
+  static int avx2 = -1;
+  if (avx2 < 0) {
+    __builtin_cpu_init();
+    avx2 = __builtin_cpu_supports("avx2") != 0;
+  }
+  return avx2;
+}
+
+/** Run the best kernel for this CPU, returning # of elements done */
+#define SIMD_KERNEL(kernel, ...) \
+  (has_avx2() ? kernel##_avx2(__VA_ARGS__) : kernel##_sse2(__VA_ARGS__))
+
+#else //!BCD_BATCH_SIMD
+
+#define SIMD_KERNEL(kernel, ...) 0
+
+#endif //if BCD_BATCH_SIMD
+
+/** Set out[i] to binary_to_bcd(in[i]) for 0 <= i < n. */
+unsigned
+binary_to_bcd_n(const Binary *in, Bcd *out, size_t n, BcdError *errs)
+{
+  unsigned summary = 0;
+  size_t i = SIMD_KERNEL(binary_to_bcd_n, in, out, n, errs, &summary);
+  for (; i < n; i++) {
+    BcdError err = OK_ERR;
+    out[i] = binary_to_bcd(in[i], &err);
+    summary |= note_error(err, errs, i);
+  }
+  return summary;
+}
+
+/** Set out[i] to bcd_to_binary(in[i]) for 0 <= i < n. */
+unsigned
+bcd_to_binary_n(const Bcd *in, Binary *out, size_t n, BcdError *errs)
+{
+  unsigned summary = 0;
+  size_t i = SIMD_KERNEL(bcd_to_binary_n, in, out, n, errs, &summary);
+  for (; i < n; i++) {
+    BcdError err = OK_ERR;
+    out[i] = bcd_to_binary(in[i], &err);
+    summary |= note_error(err, errs, i);
+  }
+  return summary;
+}
+
+/** Set out[i] to bcd_add(x[i], y[i]) for 0 <= i < n. */
+unsigned
+bcd_add_n(const Bcd *x, const Bcd *y, Bcd *out, size_t n, BcdError *errs)
+{
+  unsigned summary = 0;
+  size_t i = SIMD_KERNEL(bcd_add_n, x, y, out, n, errs, &summary);
+  for (; i < n; i++) {
+    BcdError err = OK_ERR;
+    out[i] = bcd_add(x[i], y[i], &err);
+    summary |= note_error(err, errs, i);
+  }
+  return summary;
+}
+
+/** Set out[i] to bcd_multiply(x[i], y[i]) for 0 <= i < n. */
+unsigned
+bcd_multiply_n(const Bcd *x, const Bcd *y, Bcd *out, size_t n,
+               BcdError *errs)
+{
+  unsigned summary = 0;
+  size_t i = SIMD_KERNEL(bcd_multiply_n, x, y, out, n, errs, &summary);
+  for (; i < n; i++) {
+    BcdError err = OK_ERR;
+    out[i] = bcd_multiply(x[i], y[i], &err);
+    summary |= note_error(err, errs, i);
+  }
+  return summary;
+}
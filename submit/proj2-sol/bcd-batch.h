@@ -0,0 +1,49 @@
+
+
+#ifndef BCD_BATCH_H_
+#define BCD_BATCH_H_
+
+#include "bcd.h"
+
+#include <stddef.h>
+
+//Batch versions of the bcd.h API which operate on n elements of
+//contiguous arrays.  Element i of the output is the value which the
+//corresponding single-value function returns for element i of the
+//input(s), 0 when that element has an error.
+//
+//Errors are reported in two ways:
+//
+//  If errs is not NULL, errs[i] is always set: to the error for
+//  element i, or to OK_ERR if there was none (unlike the single-value
+//  API, which leaves *error unchanged when there is no error).
+//
+//  The return value is a summary bitmap which has BCD_ERR_BIT(e) set
+//  iff some element had error e != OK_ERR; it is 0 iff every element
+//  was converted successfully.
+//
+//Outputs must not partially overlap inputs, but out may be the same
+//array as an input.  SSE2/AVX2 kernels are selected at run time when
+//available (compile with -DBCD_BATCH_SIMD=0 to always use the portable
+//scalar loops).
+
+/** bit set in a batch summary for error err */
+#define BCD_ERR_BIT(err) (1u << (err))
+
+/** Set out[i] to binary_to_bcd(in[i]) for 0 <= i < n. */
+unsigned binary_to_bcd_n(const Binary *in, Bcd *out, size_t n,
+                         BcdError *errs);
+
+/** Set out[i] to bcd_to_binary(in[i]) for 0 <= i < n. */
+unsigned bcd_to_binary_n(const Bcd *in, Binary *out, size_t n,
+                         BcdError *errs);
+
+/** Set out[i] to bcd_add(x[i], y[i]) for 0 <= i < n. */
+unsigned bcd_add_n(const Bcd *x, const Bcd *y, Bcd *out, size_t n,
+                   BcdError *errs);
+
+/** Set out[i] to bcd_multiply(x[i], y[i]) for 0 <= i < n. */
+unsigned bcd_multiply_n(const Bcd *x, const Bcd *y, Bcd *out, size_t n,
+                        BcdError *errs);
+
+#endif //ifndef BCD_BATCH_H_
@@ -0,0 +1,226 @@
+
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bcd.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//Time each function of the BCD API for the Bcd selected by BCD_BASE
+//over randomized inputs and the worst-case patterns used by
+//bcd-test.c, writing one CSV line per function and input.
+
+enum {
+  DEFAULT_N_OPS = 1000000,
+
+  //each measurement is repeated and the fastest run reported
+  N_REPEATS = 3
+};
+
+typedef struct {
+  const char *name;       //name of input in CSV output
+  Binary binary[2];       //pattern for operands x and y
+  bool isRandom;          //ignore binary[] and use random values
+} Input;
+
+/** Operands for one function and input, each array with nOps entries */
+typedef struct {
+  size_t nOps;
+  Binary *binary;
+  Bcd *x;
+  Bcd *y;
+  char (*str)[BCD_BUF_SIZE];
+} Operands;
+
+//result of every operation is accumulated here so it cannot be
+//optimized away
+static volatile unsigned long long sink;
+
+/** Return a 64-bit pseudo-random number (xorshift64) */
+static unsigned long long
+random64(void)
+{
+  static unsigned long long state = 0x2545F4914F6CDD1DULL;
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+/** Return a binary value with all MAX_BCD_DIGITS digits equal to
+ *  digit, or consecutive digits 123...890... if digit < 0 (as in
+ *  bcd-test.c).
+ */
+static Binary
+make_binary(int digit)
+{
+  Binary val = 0;
+  int d = 1;
+  for (int i = 0; i < MAX_BCD_DIGITS; i++) {
+    val = val*10 + (digit < 0 ? d : digit);
+    d = (d + 1)%10;
+  }
+  return val;
+}
+
+static double
+now_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec*1e9 + t.tv_nsec;
+}
+
+/** Fill ops for input; random values are no more than half of the max
+ *  so that their sums do not overflow.
+ */
+static void
+fill_operands(const Input *input, Operands *ops)
+{
+  for (size_t i = 0; i < ops->nOps; i++) {
+    Binary b[2];
+    for (int k = 0; k < 2; k++) {
+      b[k] = input->isRandom
+        ? random64() % (BCD_MAX_BINARY/2 + 1) : input->binary[k];
+    }
+    ops->binary[i] = b[0];
+    ops->x[i] = binary_to_bcd(b[0], NULL);
+    ops->y[i] = binary_to_bcd(b[1], NULL);
+    bcd_to_str(ops->x[i], ops->str[i], BCD_BUF_SIZE, NULL);
+  }
+}
+
+typedef enum {
+  BINARY_TO_BCD, BCD_TO_BINARY, STR_TO_BCD, BCD_TO_STR, BCD_ADD,
+  BCD_MULTIPLY, N_FNS
+} Fn;
+
+static const char *FN_NAMES[] = {
+  "binary_to_bcd", "bcd_to_binary", "str_to_bcd", "bcd_to_str",
+  "bcd_add", "bcd_multiply",
+};
+
+/** Return the time in ns for running fn over all of ops */
+static double
+time_fn(Fn fn, const Operands *ops)
+{
+  unsigned long long acc = 0;
+  const size_t n = ops->nOps;
+  char buf[BCD_BUF_SIZE];
+  const char *p;
+  double start = now_ns();
+  switch (fn) {
+    case BINARY_TO_BCD:
+      for (size_t i = 0; i < n; i++) {
+        BcdError err = OK_ERR;
+        acc += binary_to_bcd(ops->binary[i], &err);
+      }
+      break;
+    case BCD_TO_BINARY:
+      for (size_t i = 0; i < n; i++) {
+        BcdError err = OK_ERR;
+        acc += bcd_to_binary(ops->x[i], &err);
+      }
+      break;
+    case STR_TO_BCD:
+      for (size_t i = 0; i < n; i++) {
+        BcdError err = OK_ERR;
+        acc += str_to_bcd(ops->str[i], &p, &err);
+      }
+      break;
+    case BCD_TO_STR:
+      for (size_t i = 0; i < n; i++) {
+        BcdError err = OK_ERR;
+        acc += bcd_to_str(ops->x[i], buf, sizeof(buf), &err);
+      }
+      break;
+    case BCD_ADD:
+      for (size_t i = 0; i < n; i++) {
+        BcdError err = OK_ERR;
+        acc += bcd_add(ops->x[i], ops->y[i], &err);
+      }
+      break;
+    case BCD_MULTIPLY:
+      for (size_t i = 0; i < n; i++) {
+        BcdError err = OK_ERR;
+        acc += bcd_multiply(ops->x[i], ops->y[i], &err);
+      }
+      break;
+    default:
+      break;
+  }
+  double elapsed = now_ns() - start;
+  sink += acc;
+  return elapsed;
+}
+
+static void
+usage(const char *prog)
+{
+  fprintf(stderr, "usage: %s [-H] [N_OPS]\n", prog);
+  fprintf(stderr, "  -H: do not output a CSV header line\n");
+  exit(1);
+}
+
+int
+main(int argc, char *argv[])
+{
+  bool isHeader = true;
+  size_t nOps = DEFAULT_N_OPS;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-H") == 0) {
+      isHeader = false;
+    }
+    else {
+      char *end;
+      nOps = strtoul(argv[i], &end, 10);
+      if (*end != '\0' || nOps == 0) usage(argv[0]);
+    }
+  }
+
+  const Binary max = make_binary(9);
+  const Input inputs[] = {
+    { "random", { 0, 0 }, true },
+    { "max", { max, 1 }, false },           //add: carries through all
+    { "max4", { max - 4, 9 }, false },      //multiply: carries, overflow
+    { "consecutive", { make_binary(-1), make_binary(-1) }, false },
+  };
+  Operands ops = {
+    .nOps = nOps,
+    .binary = calloc(nOps, sizeof(Binary)),
+    .x = calloc(nOps, sizeof(Bcd)),
+    .y = calloc(nOps, sizeof(Bcd)),
+    .str = calloc(nOps, BCD_BUF_SIZE),
+  };
+  if (!ops.binary || !ops.x || !ops.y || !ops.str) {
+    fprintf(stderr, "cannot allocate %zu operands\n", nOps);
+    exit(1);
+  }
+
+  if (isHeader) {
+    printf("bcd_base,bcd_bytes,function,input,n_ops,ns_per_op,mops_per_s\n");
+  }
+  for (size_t k = 0; k < sizeof(inputs)/sizeof(inputs[0]); k++) {
+    fill_operands(&inputs[k], &ops);
+    for (Fn fn = 0; fn < N_FNS; fn++) {
+      double best = 0;
+      for (int r = 0; r < N_REPEATS; r++) {
+        double ns = time_fn(fn, &ops);
+        if (r == 0 || ns < best) best = ns;
+      }
+      const double nsPerOp = best/nOps;
+      printf("%d,%zu,%s,%s,%zu,%.2f,%.2f\n", BCD_BASE, sizeof(Bcd),
+             FN_NAMES[fn], inputs[k].name, nOps, nsPerOp, 1e3/nsPerOp);
+    }
+  }
+
+  free(ops.binary);
+  free(ops.x);
+  free(ops.y);
+  free(ops.str);
+  return 0;
+}
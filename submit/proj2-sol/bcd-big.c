@@ -0,0 +1,344 @@
+
+
+#include "bcd-big.h"
+#include "bcd-swar.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/************************** Storage Management *************************/
+
+static inline BcdLimb *
+get_limbs(BcdBig *big)
+{
+  return (big->heap) ? big->heap : big->inlineLimbs;
+}
+
+static inline const BcdLimb *
+get_const_limbs(const BcdBig *big)
+{
+  return (big->heap) ? big->heap : big->inlineLimbs;
+}
+
+/** Ensure big has room for nLimbs limbs, keeping its current limbs.
+ *  Invalidates limb pointers previously obtained for big.
+ */
+static void
+reserve_bcd_big(BcdBig *big, size_t nLimbs)
+{
+  if (nLimbs <= big->capacity) return;
+  size_t capacity = (2*big->capacity > nLimbs) ? 2*big->capacity : nLimbs;
+  BcdLimb *limbs = realloc(big->heap, capacity*sizeof(BcdLimb));
+  if (!limbs) {
+    fprintf(stderr, "cannot alloc BcdBig limbs: %s\n", strerror(errno));
+    exit(1);
+  }
+  if (!big->heap) {
+    memcpy(limbs, big->inlineLimbs, big->nLimbs*sizeof(BcdLimb));
+  }
+  big->heap = limbs;
+  big->capacity = capacity;
+}
+
+/** Drop most-significant zero limbs, keeping at least one limb */
+static void
+normalize_bcd_big(BcdBig *big)
+{
+  const BcdLimb *limbs = get_const_limbs(big);
+  while (big->nLimbs > 1 && limbs[big->nLimbs - 1] == 0) big->nLimbs--;
+}
+
+static void
+set_zero_bcd_big(BcdBig *big)
+{
+  big->nLimbs = 1;
+  get_limbs(big)[0] = 0;
+}
+
+/** Return true iff some limb of big contains a digit > 9 */
+static bool
+has_bad_digits_bcd_big(const BcdBig *big)
+{
+  const BcdLimb *limbs = get_const_limbs(big);
+  BcdLimb bad = 0;
+  for (size_t i = 0; i < big->nLimbs; i++) {
+    bad |= bcd_swar_bad_digits(limbs[i]);
+  }
+  return bad != 0;
+}
+
+/** Return limb i of big, 0 beyond its most-significant limb */
+static inline BcdLimb
+get_limb(const BcdLimb limbs[], size_t nLimbs, size_t i)
+{
+  return (i < nLimbs) ? limbs[i] : 0;
+}
+
+/** Initialize big to 0. */
+void
+init_bcd_big(BcdBig *big)
+{
+  big->heap = NULL;
+  big->capacity = BCD_BIG_INLINE_LIMBS;
+  set_zero_bcd_big(big);
+}
+
+/** Release any heap storage used by big; big may be reinitialized. */
+void
+free_bcd_big(BcdBig *big)
+{
+  free(big->heap);
+  init_bcd_big(big);
+}
+
+/** Set dest to a copy of src. */
+void
+bcd_big_copy(BcdBig *dest, const BcdBig *src)
+{
+  if (dest == src) return;
+  reserve_bcd_big(dest, src->nLimbs);
+  memcpy(get_limbs(dest), get_const_limbs(src),
+         src->nLimbs*sizeof(BcdLimb));
+  dest->nLimbs = src->nLimbs;
+}
+
+/***************************** Conversions *****************************/
+
+/** Set big to the value of bcd. */
+void
+bcd_to_bcd_big(Bcd bcd, BcdBig *big, BcdError *error)
+{
+  if (bcd_swar_bad_digits(bcd)) {
+    if (error) *error = BAD_VALUE_ERR;
+    bcd = 0;
+  }
+  big->nLimbs = 1;
+  get_limbs(big)[0] = bcd;
+}
+
+/** Return the value of big as a Bcd. */
+Bcd
+bcd_big_to_bcd(const BcdBig *big, BcdError *error)
+{
+  const BcdLimb low = get_const_limbs(big)[0];
+  if (big->nLimbs > 1 || low != (Bcd)low) {
+    if (error) *error = OVERFLOW_ERR;
+    return 0;
+  }
+  return low;
+}
+
+/** Set big to the decimal number given by the digits at the start of
+ *  s and set *p to point to the first non-digit char in s (to s if
+ *  there are no digits, like strtol()).
+ */
+void
+str_to_bcd_big(const char *s, const char **p, BcdBig *big)
+{
+  const char *q = s;
+  while (isspace((unsigned char)*q)) q++;
+  if (*q == '+') q++;
+  const char *end = q;
+  while (isdigit((unsigned char)*end)) end++;
+  if (p) *p = (end == q) ? s : end;
+  while (end - q > 1 && *q == '0') q++;   //non-significant zeros
+
+  const size_t nDigits = end - q;
+  const size_t nLimbs =
+    (nDigits == 0) ? 1 : (nDigits + BCD_LIMB_DIGITS - 1)/BCD_LIMB_DIGITS;
+  reserve_bcd_big(big, nLimbs);
+  BcdLimb *limbs = get_limbs(big);
+  memset(limbs, 0, nLimbs*sizeof(BcdLimb));
+  for (size_t i = 0; i < nDigits; i++) {
+    const BcdLimb digit = end[-1 - (ptrdiff_t)i] - '0';
+    limbs[i/BCD_LIMB_DIGITS] |= digit << (i%BCD_LIMB_DIGITS*BCD_BITS);
+  }
+  big->nLimbs = nLimbs;
+  normalize_bcd_big(big);
+}
+
+/** Return the # of significant digits in limb (1 for 0) */
+static inline unsigned
+limb_n_digits(BcdLimb limb)
+{
+  return (limb == 0) ? 1 : BCD_LIMB_DIGITS - __builtin_clzll(limb)/BCD_BITS;
+}
+
+/** Return the # of digits in big without leading zeros (1 for 0). */
+size_t
+bcd_big_n_digits(const BcdBig *big)
+{
+  const BcdLimb *limbs = get_const_limbs(big);
+  const size_t top = big->nLimbs - 1;
+  return top*BCD_LIMB_DIGITS + limb_n_digits(limbs[top]);
+}
+
+/** Convert big to a NUL-terminated string in buf[]. */
+int
+bcd_big_to_str(const BcdBig *big, char buf[], size_t bufSize,
+               BcdError *error)
+{
+  const size_t nDigits = bcd_big_n_digits(big);
+  if (has_bad_digits_bcd_big(big)) {
+    if (error) *error = BAD_VALUE_ERR;
+    return 0;
+  }
+  if (bufSize < nDigits + 1) {
+    if (error) *error = OVERFLOW_ERR;
+    return 0;
+  }
+  const BcdLimb *limbs = get_const_limbs(big);
+  for (size_t i = 0; i < nDigits; i++) {
+    const BcdLimb limb = limbs[i/BCD_LIMB_DIGITS];
+    const unsigned digit = (limb >> (i%BCD_LIMB_DIGITS*BCD_BITS)) & 0xF;
+    buf[nDigits - 1 - i] = '0' + digit;
+  }
+  buf[nDigits] = '\0';
+  return nDigits;
+}
+
+/***************************** Arithmetic ******************************/
+
+/** Return < 0, 0 or > 0 as x is less than, equal to or greater than y. */
+int
+bcd_big_compare(const BcdBig *x, const BcdBig *y)
+{
+  if (x->nLimbs != y->nLimbs) return (x->nLimbs < y->nLimbs) ? -1 : 1;
+  const BcdLimb *xLimbs = get_const_limbs(x);
+  const BcdLimb *yLimbs = get_const_limbs(y);
+  //packed BCD limbs order the same as their values
+  for (size_t i = x->nLimbs; i-- > 0; ) {
+    if (xLimbs[i] != yLimbs[i]) return (xLimbs[i] < yLimbs[i]) ? -1 : 1;
+  }
+  return 0;
+}
+
+/** Set result to x + y; result may be the same as x or y. */
+void
+bcd_big_add(const BcdBig *x, const BcdBig *y, BcdBig *result,
+            BcdError *error)
+{
+  if (has_bad_digits_bcd_big(x) || has_bad_digits_bcd_big(y)) {
+    if (error) *error = BAD_VALUE_ERR;
+    set_zero_bcd_big(result);
+    return;
+  }
+  const size_t nX = x->nLimbs, nY = y->nLimbs;
+  const size_t n = (nX > nY) ? nX : nY;
+  reserve_bcd_big(result, n + 1);   //before taking limb pointers
+  const BcdLimb *xLimbs = get_const_limbs(x);
+  const BcdLimb *yLimbs = get_const_limbs(y);
+  BcdLimb *limbs = get_limbs(result);
+  unsigned carry = 0;
+  for (size_t i = 0; i < n; i++) {
+    limbs[i] = bcd_swar_add(get_limb(xLimbs, nX, i), get_limb(yLimbs, nY, i),
+                            carry, &carry);
+  }
+  limbs[n] = carry;
+  result->nLimbs = n + 1;
+  normalize_bcd_big(result);
+}
+
+/** Set result to x - y; result may be the same as x or y. */
+void
+bcd_big_subtract(const BcdBig *x, const BcdBig *y, BcdBig *result,
+                 BcdError *error)
+{
+  if (has_bad_digits_bcd_big(x) || has_bad_digits_bcd_big(y)) {
+    if (error) *error = BAD_VALUE_ERR;
+    set_zero_bcd_big(result);
+    return;
+  }
+  if (bcd_big_compare(x, y) < 0) {
+    if (error) *error = OVERFLOW_ERR;
+    set_zero_bcd_big(result);
+    return;
+  }
+  const size_t nX = x->nLimbs, nY = y->nLimbs;
+  reserve_bcd_big(result, nX);
+  const BcdLimb *xLimbs = get_const_limbs(x);
+  const BcdLimb *yLimbs = get_const_limbs(y);
+  BcdLimb *limbs = get_limbs(result);
+  unsigned borrow = 0;
+  for (size_t i = 0; i < nX; i++) {
+    limbs[i] = bcd_swar_sub(xLimbs[i], get_limb(yLimbs, nY, i),
+                            borrow, &borrow);
+  }
+  result->nLimbs = nX;
+  normalize_bcd_big(result);
+}
+
+/** Add m shifted left by shift digits into acc[] which has room for
+ *  the complete sum.
+ */
+static void
+add_shifted_limbs(BcdLimb acc[], const BcdLimb m[], size_t nM, size_t shift)
+{
+  const size_t limbShift = shift/BCD_LIMB_DIGITS;
+  const unsigned bitShift = shift%BCD_LIMB_DIGITS*BCD_BITS;
+  unsigned carry = 0;
+  size_t i = 0;
+  for (; i <= nM; i++) {
+    BcdLimb v = (bitShift == 0)
+      ? get_limb(m, nM, i)
+      : (get_limb(m, nM, i) << bitShift) |
+        ((i > 0) ? m[i - 1] >> (64 - bitShift) : 0);
+    acc[limbShift + i] = bcd_swar_add(acc[limbShift + i], v, carry, &carry);
+  }
+  for (; carry; i++) {
+    acc[limbShift + i] = bcd_swar_add(acc[limbShift + i], 0, carry, &carry);
+  }
+}
+
+/** Set result to x * y; result may be the same as x or y.
+ *
+ *  The multiples x*0 ... x*9 are built with the packed adder, then
+ *  for every digit of y the matching multiple is added in at the
+ *  digit's position.  No binary conversion is involved.
+ */
+void
+bcd_big_multiply(const BcdBig *x, const BcdBig *y, BcdBig *result,
+                 BcdError *error)
+{
+  if (has_bad_digits_bcd_big(x) || has_bad_digits_bcd_big(y)) {
+    if (error) *error = BAD_VALUE_ERR;
+    set_zero_bcd_big(result);
+    return;
+  }
+  BcdBig multiples[10];
+  init_bcd_big(&multiples[0]);
+  init_bcd_big(&multiples[1]);
+  bcd_big_copy(&multiples[1], x);
+  for (int d = 2; d < 10; d++) {
+    init_bcd_big(&multiples[d]);
+    bcd_big_add(&multiples[d - 1], x, &multiples[d], NULL);
+  }
+
+  BcdBig product;
+  init_bcd_big(&product);
+  const size_t nProduct = x->nLimbs + y->nLimbs + 1;
+  reserve_bcd_big(&product, nProduct);
+  BcdLimb *acc = get_limbs(&product);
+  memset(acc, 0, nProduct*sizeof(BcdLimb));
+
+  const BcdLimb *yLimbs = get_const_limbs(y);
+  for (size_t i = 0; i < y->nLimbs; i++) {
+    BcdLimb limb = yLimbs[i];
+    for (unsigned k = 0; limb != 0; k++, limb >>= BCD_BITS) {
+      const unsigned d = limb & 0xF;
+      if (d == 0) continue;
+      add_shifted_limbs(acc, get_const_limbs(&multiples[d]),
+                        multiples[d].nLimbs, i*BCD_LIMB_DIGITS + k);
+    }
+  }
+  product.nLimbs = nProduct;
+  normalize_bcd_big(&product);
+
+  for (int d = 0; d < 10; d++) free_bcd_big(&multiples[d]);
+  free_bcd_big(result);
+  *result = product;
+}
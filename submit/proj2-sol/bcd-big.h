@@ -0,0 +1,114 @@
+
+
+#ifndef BCD_BIG_H_
+#define BCD_BIG_H_
+
+#include "bcd.h"
+
+#include <stddef.h>
+
+/** A limb holds 16 packed BCD digits */
+typedef unsigned long long BcdLimb;
+
+enum {
+  //# of BCD digits in a BcdLimb
+  BCD_LIMB_DIGITS = sizeof(BcdLimb) * CHAR_BIT / BCD_BITS,
+
+  //# of limbs stored within a BcdBig itself (48 digits)
+  BCD_BIG_INLINE_LIMBS = 3
+};
+
+/** Arbitrary-precision unsigned packed BCD number.  Limb 0 holds the 16
+ *  least-significant digits.  Numbers which fit in
+ *  BCD_BIG_INLINE_LIMBS limbs are held in inlineLimbs[] without any
+ *  heap allocation.
+ *
+ *  Treat as opaque: initialize with init_bcd_big() before use, release
+ *  with free_bcd_big() and copy only with bcd_big_copy().
+ */
+typedef struct {
+  size_t nLimbs;        /** # of limbs in use; top limb != 0 unless 1 */
+  size_t capacity;      /** # of limbs available */
+  BcdLimb *heap;        /** heap limbs, NULL while inline */
+  BcdLimb inlineLimbs[BCD_BIG_INLINE_LIMBS];
+} BcdBig;
+
+/** Initialize big to 0. */
+void init_bcd_big(BcdBig *big);
+
+/** Release any heap storage used by big; big may be reinitialized. */
+void free_bcd_big(BcdBig *big);
+
+/** Set dest to a copy of src. */
+void bcd_big_copy(BcdBig *dest, const BcdBig *src);
+
+/** Set big to the value of bcd.
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if bcd contains
+ *  a BCD digit which is greater than 9, otherwise *error is unchanged.
+ */
+void bcd_to_bcd_big(Bcd bcd, BcdBig *big, BcdError *error);
+
+/** Return the value of big as a Bcd.
+ *
+ *  If error is not NULL, sets *error to OVERFLOW_ERR if big has more
+ *  than MAX_BCD_DIGITS digits, otherwise *error is unchanged.
+ */
+Bcd bcd_big_to_bcd(const BcdBig *big, BcdError *error);
+
+/** Set big to the decimal number given by the digits at the start of
+ *  s and set *p to point to the first non-digit char in s.  Like
+ *  str_to_bcd(), leading whitespace and an optional '+' are skipped;
+ *  if there are no digits, big is set to 0 and *p to s.  Any number of
+ *  digits is accepted.
+ */
+void str_to_bcd_big(const char *s, const char **p, BcdBig *big);
+
+/** Return the # of digits in big without non-significant leading
+ *  zeros (1 for 0).  A buffer for bcd_big_to_str() needs 1 more char.
+ */
+size_t bcd_big_n_digits(const BcdBig *big);
+
+/** Convert big to a NUL-terminated string in buf[] without any
+ *  non-significant leading zeros.  Never write more than bufSize
+ *  characters into buf.  The return value is the number of characters
+ *  written (excluding the terminating NUL).
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if big contains
+ *  a BCD digit which is greater than 9, OVERFLOW_ERR if bufSize is
+ *  less than bcd_big_n_digits(big) + 1, otherwise *error is unchanged.
+ */
+int bcd_big_to_str(const BcdBig *big, char buf[], size_t bufSize,
+                   BcdError *error);
+
+/** Return < 0, 0 or > 0 as x is less than, equal to or greater than y. */
+int bcd_big_compare(const BcdBig *x, const BcdBig *y);
+
+/** Set result to x + y; result may be the same as x or y.
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if x or y
+ *  contains a BCD digit which is greater than 9, otherwise *error is
+ *  unchanged.
+ */
+void bcd_big_add(const BcdBig *x, const BcdBig *y, BcdBig *result,
+                 BcdError *error);
+
+/** Set result to x - y; result may be the same as x or y.
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if x or y
+ *  contains a BCD digit which is greater than 9, OVERFLOW_ERR if
+ *  x < y (result is then 0), otherwise *error is unchanged.
+ */
+void bcd_big_subtract(const BcdBig *x, const BcdBig *y, BcdBig *result,
+                      BcdError *error);
+
+/** Set result to x * y; result may be the same as x or y.
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if x or y
+ *  contains a BCD digit which is greater than 9, otherwise *error is
+ *  unchanged.
+ */
+void bcd_big_multiply(const BcdBig *x, const BcdBig *y, BcdBig *result,
+                      BcdError *error);
+
+#endif //ifndef BCD_BIG_H_
@@ -0,0 +1,418 @@
+
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bcd-calc.h"
+#include "bcd-batch.h"
+#include "bcd.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum {
+  //# of lines handed to the batch API at a time
+  CALC_BLOCK_LINES = 1024,
+
+  //max # of chars output for a result: "DIGITS (RAW)\n"
+  CALC_RESULT_MAX = BCD_BUF_SIZE + 2 + 20 + 2,
+
+  //initial size of a buffer used to read a file which cannot be mapped
+  CALC_READ_SIZE = 1 << 16
+};
+
+typedef enum { OP_NONE, OP_ADD, OP_MULTIPLY } CalcOp;
+
+/** Text of an input file: mapped, or read into a malloc'd buffer.
+ *  Either way text[size] is a NUL, so the parser never needs to
+ *  check for the end of the text within a line.
+ */
+typedef struct {
+  const char *text;
+  size_t size;
+  bool isMapped;
+} CalcInput;
+
+/** A range of whole lines of the input and the output for them */
+typedef struct {
+  const char *begin;
+  const char *end;
+  char *out;
+  size_t outLen;
+  size_t outCapacity;
+} CalcChunk;
+
+/** A block of lines: parsed operands, then results.  The g* arrays
+ *  hold the operands of one operator gathered contiguously for the
+ *  batch API, gIndex[] the line each came from.
+ */
+typedef struct {
+  int nLines;
+  const char *line[CALC_BLOCK_LINES];
+  size_t lineLen[CALC_BLOCK_LINES];
+  CalcOp op[CALC_BLOCK_LINES];
+  bool isJunk[CALC_BLOCK_LINES];
+  BcdError err[CALC_BLOCK_LINES];
+  Bcd x[CALC_BLOCK_LINES];
+  Bcd y[CALC_BLOCK_LINES];
+  Bcd result[CALC_BLOCK_LINES];
+  Bcd gX[CALC_BLOCK_LINES];
+  Bcd gY[CALC_BLOCK_LINES];
+  Bcd gResult[CALC_BLOCK_LINES];
+  BcdError gErr[CALC_BLOCK_LINES];
+  int gIndex[CALC_BLOCK_LINES];
+} CalcBlock;
+
+/******************************* Input *********************************/
+
+/** Load the file at path into input; return non-zero on error. */
+static int
+load_input(const char *path, CalcInput *input)
+{
+  int fd = open(path, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) < 0) {
+    fprintf(stderr, "cannot open %s: %s\n", path, strerror(errno));
+    if (fd >= 0) close(fd);
+    return 1;
+  }
+
+  // A mapping is zero-filled to the end of its last page, so map the
+  // file only when that page has room for a terminating NUL.
+  const long pageSize = sysconf(_SC_PAGESIZE);
+  if (S_ISREG(st.st_mode) && st.st_size > 0 && st.st_size % pageSize != 0) {
+    void *text = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (text != MAP_FAILED) {
+      posix_madvise(text, st.st_size, POSIX_MADV_SEQUENTIAL);
+      close(fd);
+      input->text = text;
+      input->size = st.st_size;
+      input->isMapped = true;
+      return 0;
+    }
+  }
+
+  // otherwise read the whole file in large blocks
+  size_t capacity = (S_ISREG(st.st_mode) && st.st_size > 0)
+    ? (size_t)st.st_size + 1 : CALC_READ_SIZE;
+  size_t size = 0;
+  char *text = malloc(capacity);
+  while (text) {
+    if (size + 1 == capacity) {
+      char *bigger = realloc(text, 2*capacity);
+      if (!bigger) break;
+      text = bigger;
+      capacity *= 2;
+    }
+    ssize_t n = read(fd, text + size, capacity - 1 - size);
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0) {
+      fprintf(stderr, "cannot read %s: %s\n", path, strerror(errno));
+      free(text);
+      close(fd);
+      return 1;
+    }
+    if (n == 0) break;
+    size += n;
+  }
+  close(fd);
+  if (!text || size + 1 == capacity) {
+    fprintf(stderr, "cannot allocate buffer for %s\n", path);
+    free(text);
+    return 1;
+  }
+  text[size] = '\0';
+  input->text = text;
+  input->size = size;
+  input->isMapped = false;
+  return 0;
+}
+
+static void
+free_input(CalcInput *input)
+{
+  if (input->isMapped) {
+    munmap((void *)input->text, input->size);
+  }
+  else {
+    free((void *)input->text);
+  }
+}
+
+/****************************** Parsing ********************************/
+
+/** Skip blanks within a line; never moves past a '\n' */
+static inline const char *
+skip_blanks(const char *p)
+{
+  while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f') {
+    p++;
+  }
+  return p;
+}
+
+/** Parse an operand at p as str_to_bcd() would, but only if p is at a
+ *  digit, optionally after a '+', so that the parse never skips
+ *  whitespace past the line end.
+ */
+static inline Bcd
+parse_operand(const char *p, const char **end, BcdError *err)
+{
+  if ((unsigned)(p[*p == '+'] - '0') > 9) {
+    *end = p;
+    return 0;
+  }
+  return str_to_bcd(p, end, err);
+}
+
+/** Parse line [p, lineEnd) into entry i of block, in the same way as
+ *  the interactive loop in main.c.
+ */
+static void
+parse_line(const char *p, const char *lineEnd, CalcBlock *block, int i)
+{
+  BcdError err = OK_ERR;
+  CalcOp op = OP_NONE;
+  Bcd y = 0;
+  block->line[i] = p;
+  block->lineLen[i] = lineEnd - p;
+  Bcd x = parse_operand(skip_blanks(p), &p, &err);
+  if (err == OK_ERR) {
+    p = skip_blanks(p);
+    if (*p == '+' || *p == '*') {
+      op = (*p == '+') ? OP_ADD : OP_MULTIPLY;
+      y = parse_operand(skip_blanks(p + 1), &p, &err);
+    }
+    p = skip_blanks(p);
+  }
+  block->x[i] = x;
+  block->y[i] = y;
+  block->op[i] = (err == OK_ERR) ? op : OP_NONE;
+  block->err[i] = err;
+  block->isJunk[i] = (p != lineEnd);
+}
+
+/***************************** Evaluation ******************************/
+
+/** Evaluate all error-free lines of block which use op with the
+ *  batch API.
+ */
+static void
+eval_op(CalcBlock *block, CalcOp op)
+{
+  int n = 0;
+  for (int i = 0; i < block->nLines; i++) {
+    if (block->op[i] == op) {
+      block->gX[n] = block->x[i];
+      block->gY[n] = block->y[i];
+      block->gIndex[n++] = i;
+    }
+  }
+  if (n == 0) return;
+  if (op == OP_ADD) {
+    bcd_add_n(block->gX, block->gY, block->gResult, n, block->gErr);
+  }
+  else {
+    bcd_multiply_n(block->gX, block->gY, block->gResult, n, block->gErr);
+  }
+  for (int k = 0; k < n; k++) {
+    const int i = block->gIndex[k];
+    block->result[i] = block->gResult[k];
+    block->err[i] = block->gErr[k];
+  }
+}
+
+static void
+eval_block(CalcBlock *block)
+{
+  for (int i = 0; i < block->nLines; i++) {
+    if (block->op[i] == OP_NONE) block->result[i] = block->x[i];
+  }
+  eval_op(block, OP_ADD);
+  eval_op(block, OP_MULTIPLY);
+}
+
+/******************************* Output ********************************/
+
+/** Ensure chunk has room for n more output chars */
+static void
+reserve_output(CalcChunk *chunk, size_t n)
+{
+  if (chunk->outLen + n <= chunk->outCapacity) return;
+  size_t capacity = 2*chunk->outCapacity + n;
+  char *out = realloc(chunk->out, capacity);
+  if (!out) {
+    fprintf(stderr, "cannot allocate output buffer: %s\n", strerror(errno));
+    exit(1);
+  }
+  chunk->out = out;
+  chunk->outCapacity = capacity;
+}
+
+static void
+put_chars(CalcChunk *chunk, const char *s, size_t n)
+{
+  reserve_output(chunk, n);
+  memcpy(chunk->out + chunk->outLen, s, n);
+  chunk->outLen += n;
+}
+
+/** Append the decimal digits of value at p, returning the end */
+static char *
+put_decimal(char *p, unsigned long long value)
+{
+  char digits[20];
+  int n = 0;
+  do {
+    digits[n++] = '0' + value % 10;
+    value /= 10;
+  } while (value != 0);
+  while (n > 0) *p++ = digits[--n];
+  return p;
+}
+
+static const char *
+error_message(BcdError err)
+{
+  return (err == BAD_VALUE_ERR) ? "bad BCD value > 9\n" : "BCD overflow\n";
+}
+
+static void
+put_block(const CalcBlock *block, CalcChunk *chunk)
+{
+  for (int i = 0; i < block->nLines; i++) {
+    BcdError err = block->err[i];
+    if (err != OK_ERR) {
+      const char *message = error_message(err);
+      put_chars(chunk, message, strlen(message));
+    }
+    else if (block->isJunk[i]) {
+      put_chars(chunk, "bad input ", 10);
+      put_chars(chunk, block->line[i], block->lineLen[i]);
+      put_chars(chunk, "\n", 1);
+    }
+    else {
+      reserve_output(chunk, CALC_RESULT_MAX);
+      char *p = chunk->out + chunk->outLen;
+      p += bcd_to_str(block->result[i], p, BCD_BUF_SIZE, NULL);
+      *p++ = ' ';
+      *p++ = '(';
+      p = put_decimal(p, block->result[i]);
+      *p++ = ')';
+      *p++ = '\n';
+      chunk->outLen = p - chunk->out;
+    }
+  }
+}
+
+/***************************** Chunks **********************************/
+
+/** Evaluate all lines of chunk into its output buffer */
+static void *
+calc_chunk(void *arg)
+{
+  CalcChunk *chunk = arg;
+  CalcBlock *block = malloc(sizeof(CalcBlock));
+  if (!block) {
+    fprintf(stderr, "cannot allocate block: %s\n", strerror(errno));
+    exit(1);
+  }
+  reserve_output(chunk, (chunk->end - chunk->begin) * 2 + CALC_RESULT_MAX);
+  const char *p = chunk->begin;
+  while (p < chunk->end) {
+    block->nLines = 0;
+    while (p < chunk->end && block->nLines < CALC_BLOCK_LINES) {
+      const char *nl = memchr(p, '\n', chunk->end - p);
+      const char *lineEnd = nl ? nl : chunk->end;
+      parse_line(p, lineEnd, block, block->nLines++);
+      p = nl ? nl + 1 : chunk->end;
+    }
+    eval_block(block);
+    put_block(block, chunk);
+  }
+  free(block);
+  return NULL;
+}
+
+/** Split text[0, size) into nChunks ranges of whole lines */
+static void
+split_chunks(const char *text, size_t size, int nChunks, CalcChunk chunks[])
+{
+  const char *textEnd = text + size;
+  const char *p = text;
+  for (int i = 0; i < nChunks; i++) {
+    const char *end = text + size*(i + 1)/nChunks;
+    if (end < p) end = p;
+    if (end > text && end < textEnd && end[-1] != '\n') {
+      const char *nl = memchr(end, '\n', textEnd - end);
+      end = nl ? nl + 1 : textEnd;
+    }
+    chunks[i].begin = p;
+    chunks[i].end = end;
+    p = end;
+  }
+}
+
+/** Evaluate each line of the file at path as an expression a, a + b
+ *  or a * b (as accepted interactively by bcd) and write exactly one
+ *  line to out for every input line, in input order: either the
+ *  result as "DIGITS (RAW)" or an error message.
+ *
+ *  The file is split at line boundaries into chunks which are
+ *  evaluated by nThreads threads using the batch BCD API.
+ *
+ *  Returns 0 on success; on an I/O error, reports it on stderr and
+ *  returns non-zero.
+ */
+int
+calc_file(const char *path, int nThreads, FILE *out)
+{
+  CalcInput input;
+  if (load_input(path, &input) != 0) return 1;
+  if (nThreads < 1) nThreads = 1;
+  CalcChunk *chunks = calloc(nThreads, sizeof(CalcChunk));
+  pthread_t *threads = calloc(nThreads, sizeof(pthread_t));
+  bool *isThread = calloc(nThreads, sizeof(bool));
+  if (!chunks || !threads || !isThread) {
+    fprintf(stderr, "cannot allocate %d chunks\n", nThreads);
+    exit(1);
+  }
+  split_chunks(input.text, input.size, nThreads, chunks);
+
+  // chunk 0 runs on this thread; run any chunk whose thread cannot be
+  // created here too
+  for (int i = 1; i < nThreads; i++) {
+    isThread[i] = pthread_create(&threads[i], NULL, calc_chunk,
+                                 &chunks[i]) == 0;
+  }
+  calc_chunk(&chunks[0]);
+  for (int i = 1; i < nThreads; i++) {
+    if (isThread[i]) {
+      pthread_join(threads[i], NULL);
+    }
+    else {
+      calc_chunk(&chunks[i]);
+    }
+  }
+
+  int status = 0;
+  for (int i = 0; i < nThreads; i++) {
+    if (fwrite(chunks[i].out, 1, chunks[i].outLen, out) != chunks[i].outLen) {
+      fprintf(stderr, "cannot write output: %s\n", strerror(errno));
+      status = 1;
+      break;
+    }
+  }
+  for (int i = 0; i < nThreads; i++) free(chunks[i].out);
+  free(chunks);
+  free(threads);
+  free(isThread);
+  free_input(&input);
+  return status;
+}
@@ -0,0 +1,21 @@
+
+
+#ifndef BCD_CALC_H_
+#define BCD_CALC_H_
+
+#include <stdio.h>
+
+/** Evaluate each line of the file at path as an expression a, a + b
+ *  or a * b (as accepted interactively by bcd) and write exactly one
+ *  line to out for every input line, in input order: either the
+ *  result as "DIGITS (RAW)" or an error message.
+ *
+ *  The file is split at line boundaries into chunks which are
+ *  evaluated by nThreads threads using the batch BCD API.
+ *
+ *  Returns 0 on success; on an I/O error, reports it on stderr and
+ *  returns non-zero.
+ */
+int calc_file(const char *path, int nThreads, FILE *out);
+
+#endif //ifndef BCD_CALC_H_
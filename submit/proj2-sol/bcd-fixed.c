@@ -0,0 +1,336 @@
+
+
+#include "bcd-fixed.h"
+#include "bcd-swar.h"
+
+#include <ctype.h>
+#include <string.h>
+
+//Products and digits being rounded away are held as a 32-digit
+//double-width value hi:lo, with lo holding the 16 least-significant
+//digits whatever the width of a Bcd.
+
+/************************** Digit Helpers ******************************/
+
+/** Return x shifted left by n >= 0 digits; sets *isOverflow if any
+ *  non-zero digit is shifted out of the Bcd.
+ */
+static Bcd
+shift_left_digits(Bcd x, int n, bool *isOverflow)
+{
+  if (n == 0) return x;
+  if (n >= MAX_BCD_DIGITS) {
+    if (x != 0) *isOverflow = true;
+    return 0;
+  }
+  const int shift = n*BCD_BITS;
+  if ((unsigned long long)x >> (MAX_BCD_DIGITS*BCD_BITS - shift) != 0) {
+    *isOverflow = true;
+  }
+  return (unsigned long long)x << shift;
+}
+
+/** Set hi:lo to x shifted left by 0 <= n <= 16 digits; no digits are
+ *  lost.
+ */
+static void
+shift_left_wide(Bcd x, int n, unsigned long long *hi, unsigned long long *lo)
+{
+  if (n == 0) {
+    *hi = 0;
+    *lo = x;
+  }
+  else if (n < 16) {
+    *hi = (unsigned long long)x >> (16 - n)*BCD_BITS;
+    *lo = (unsigned long long)x << n*BCD_BITS;
+  }
+  else {
+    *hi = x;
+    *lo = 0;
+  }
+}
+
+/** Return digit i (0 is least-significant) of hi:lo */
+static unsigned
+wide_digit(unsigned long long hi, unsigned long long lo, int i)
+{
+  return ((i < 16) ? lo >> i*BCD_BITS : hi >> (i - 16)*BCD_BITS) & 0xF;
+}
+
+/** Return a mask for the n < 16 least-significant digits */
+static unsigned long long
+low_digits_mask(int n)
+{
+  return (1ULL << n*BCD_BITS) - 1;
+}
+
+/** Return true iff any of the n least-significant digits of hi:lo is
+ *  non-zero.
+ */
+static bool
+has_low_digits(unsigned long long hi, unsigned long long lo, int n)
+{
+  if (n < 16) return (lo & low_digits_mask(n)) != 0;
+  return lo != 0 || (n < 32 && (hi & low_digits_mask(n - 16)) != 0);
+}
+
+/** Shift hi:lo right by 0 <= n <= 32 digits */
+static void
+shift_right_wide(unsigned long long *hi, unsigned long long *lo, int n)
+{
+  if (n == 0) return;
+  if (n < 16) {
+    *lo = *lo >> n*BCD_BITS | *hi << (16 - n)*BCD_BITS;
+    *hi >>= n*BCD_BITS;
+  }
+  else {
+    *lo = (n < 32) ? *hi >> (n - 16)*BCD_BITS : 0;
+    *hi = 0;
+  }
+}
+
+/** Return hi:lo divided by 10**n (0 <= n <= 32) rounded half to even;
+ *  sets *isOverflow if the result does not fit in a Bcd.
+ */
+static Bcd
+round_shift_right(unsigned long long hi, unsigned long long lo, int n,
+                  bool *isOverflow)
+{
+  if (n > 0) {
+    const unsigned roundDigit = wide_digit(hi, lo, n - 1);
+    const bool isSticky = has_low_digits(hi, lo, n - 1);
+    shift_right_wide(&hi, &lo, n);
+    // round up above half, or at exactly half when the kept last
+    // digit is odd (BCD digit parity is just its bit 0)
+    if (roundDigit > 5 || (roundDigit == 5 && (isSticky || (lo & 1)))) {
+      unsigned carry;
+      lo = bcd_swar_add(lo, 1, 0, &carry);
+      hi = bcd_swar_add(hi, 0, carry, &carry);
+    }
+  }
+  if (hi != 0 || lo != (Bcd)lo) *isOverflow = true;
+  return lo;
+}
+
+/*************************** Construction ******************************/
+
+static bool
+is_valid_scale(int scale)
+{
+  return 0 <= scale && scale <= MAX_BCD_DIGITS;
+}
+
+static bool
+is_valid_fixed(BcdFixed x)
+{
+  return !bcd_swar_bad_digits(x.mantissa) && is_valid_scale(x.scale);
+}
+
+/** Return the BcdFixed for mantissa, scale and isNegative, or 0 with
+ *  *error set to err if err is not OK_ERR.
+ */
+static BcdFixed
+make_fixed(Bcd mantissa, int scale, bool isNegative, BcdError err,
+           BcdError *error)
+{
+  if (err != OK_ERR) {
+    if (error) *error = err;
+    return (BcdFixed){ 0, 0, false };
+  }
+  return (BcdFixed){ mantissa, scale, isNegative && mantissa != 0 };
+}
+
+/** Return the BcdFixed for mantissa, scale and isNegative, or 0 with
+ *  an OVERFLOW_ERR if isOverflow.
+ */
+static BcdFixed
+make_fixed_checked(Bcd mantissa, int scale, bool isNegative,
+                   bool isOverflow, BcdError *error)
+{
+  return make_fixed(mantissa, scale, isNegative,
+                    isOverflow ? OVERFLOW_ERR : OK_ERR, error);
+}
+
+/****************************** Strings ********************************/
+
+/** Return the fixed-point number given by an optionally signed
+ *  decimal number with an optional fraction (like "-12.50") at the
+ *  start of s.  The scale is the # of digits given after the '.'.
+ *  Sets *p to point to the first char after the number (to s if there
+ *  is no number).
+ */
+BcdFixed
+str_to_bcd_fixed(const char *s, const char **p, BcdError *error)
+{
+  const char *q = s;
+  while (isspace((unsigned char)*q)) q++;
+  const bool isNegative = (*q == '-');
+  if (*q == '-' || *q == '+') q++;
+
+  unsigned long long mantissa = 0;
+  int nDigits = 0, scale = 0;
+  bool hasDigits = false, isFraction = false, isOverflow = false;
+  for (; isdigit((unsigned char)*q) || (*q == '.' && !isFraction); q++) {
+    if (*q == '.') {
+      isFraction = true;
+      continue;
+    }
+    hasDigits = true;
+    if (isFraction) scale++;
+    if (nDigits == 0 && *q == '0') continue;    //not significant
+    if (nDigits == MAX_BCD_DIGITS) {
+      isOverflow = true;
+    }
+    else {
+      mantissa = mantissa << BCD_BITS | (*q - '0');
+      nDigits++;
+    }
+  }
+  if (!hasDigits) {
+    *p = s;
+    return make_fixed(0, 0, false, OK_ERR, error);
+  }
+  *p = q;
+  return make_fixed_checked(mantissa, scale, isNegative,
+                            isOverflow || !is_valid_scale(scale), error);
+}
+
+/** Convert x to a NUL-terminated string in buf[] with exactly
+ *  x.scale digits after the decimal point.  Never write more than
+ *  bufSize characters into buf.  The return value is the number of
+ *  characters written (excluding the terminating NUL).
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if x is not
+ *  valid, OVERFLOW_ERR if bufSize is less than BCD_FIXED_BUF_SIZE,
+ *  otherwise *error is unchanged.
+ */
+int
+bcd_fixed_to_str(BcdFixed x, char buf[], size_t bufSize, BcdError *error)
+{
+  if (!is_valid_fixed(x)) {
+    if (error) *error = BAD_VALUE_ERR;
+    return 0;
+  }
+  if (bufSize < BCD_FIXED_BUF_SIZE) {
+    if (error) *error = OVERFLOW_ERR;
+    return 0;
+  }
+  char digits[BCD_BUF_SIZE];
+  const int n = bcd_to_str(x.mantissa, digits, sizeof(digits), NULL);
+  const int nFraction = (n < x.scale) ? n : x.scale;
+  char *p = buf;
+  if (x.isNegative) *p++ = '-';
+  if (n > x.scale) {
+    memcpy(p, digits, n - x.scale);
+    p += n - x.scale;
+  }
+  else {
+    *p++ = '0';
+  }
+  if (x.scale > 0) {
+    *p++ = '.';
+    memset(p, '0', x.scale - nFraction);
+    p += x.scale - nFraction;
+    memcpy(p, &digits[n - nFraction], nFraction);
+    p += nFraction;
+  }
+  *p = '\0';
+  return p - buf;
+}
+
+/**************************** Arithmetic *******************************/
+
+/** Return x with scale digits after the decimal point. */
+BcdFixed
+bcd_fixed_rescale(BcdFixed x, int scale, BcdError *error)
+{
+  if (!is_valid_fixed(x) || !is_valid_scale(scale)) {
+    return make_fixed(0, 0, false, BAD_VALUE_ERR, error);
+  }
+  bool isOverflow = false;
+  Bcd mantissa = (scale >= x.scale)
+    ? shift_left_digits(x.mantissa, scale - x.scale, &isOverflow)
+    : round_shift_right(0, x.mantissa, x.scale - scale, &isOverflow);
+  return make_fixed_checked(mantissa, scale, x.isNegative, isOverflow,
+                            error);
+}
+
+/** Return x + y after aligning both to the larger scale; the sum of
+ *  magnitudes with opposite signs is computed as the 10's complement
+ *  difference of the larger and smaller magnitude.  That difference is
+ *  taken at double width since an aligned operand which does not fit
+ *  in a Bcd may still leave a difference which does.
+ */
+BcdFixed
+bcd_fixed_add(BcdFixed x, BcdFixed y, BcdError *error)
+{
+  if (!is_valid_fixed(x) || !is_valid_fixed(y)) {
+    return make_fixed(0, 0, false, BAD_VALUE_ERR, error);
+  }
+  const int scale = (x.scale > y.scale) ? x.scale : y.scale;
+  bool isOverflow = false;
+  unsigned carry;
+  unsigned long long sum;
+  bool isNegative = x.isNegative;
+  if (x.isNegative == y.isNegative) {
+    //the sum is at least as long as either aligned operand
+    const Bcd a = shift_left_digits(x.mantissa, scale - x.scale, &isOverflow);
+    const Bcd b = shift_left_digits(y.mantissa, scale - y.scale, &isOverflow);
+    sum = bcd_swar_add(a, b, 0, &carry);
+    isOverflow |= carry || sum != (Bcd)sum;
+  }
+  else {
+    unsigned long long aHi, aLo, bHi, bLo, hi, lo;
+    shift_left_wide(x.mantissa, scale - x.scale, &aHi, &aLo);
+    shift_left_wide(y.mantissa, scale - y.scale, &bHi, &bLo);
+    lo = bcd_swar_sub(aLo, bLo, 0, &carry);
+    hi = bcd_swar_sub(aHi, bHi, carry, &carry);
+    if (carry) {                //|x| < |y|: the result takes y's sign
+      lo = bcd_swar_sub(bLo, aLo, 0, &carry);
+      hi = bcd_swar_sub(bHi, aHi, carry, &carry);
+      isNegative = y.isNegative;
+    }
+    sum = round_shift_right(hi, lo, 0, &isOverflow);
+  }
+  return make_fixed_checked(sum, scale, isNegative, isOverflow, error);
+}
+
+/** Return x - y with the larger of their scales. */
+BcdFixed
+bcd_fixed_subtract(BcdFixed x, BcdFixed y, BcdError *error)
+{
+  y.isNegative = !y.isNegative;
+  return bcd_fixed_add(x, y, error);
+}
+
+/** Return x * y rounded to scale digits after the decimal point: the
+ *  exact double-width product has x.scale + y.scale fraction digits.
+ */
+BcdFixed
+bcd_fixed_multiply(BcdFixed x, BcdFixed y, int scale, BcdError *error)
+{
+  if (!is_valid_fixed(x) || !is_valid_fixed(y) || !is_valid_scale(scale)) {
+    return make_fixed(0, 0, false, BAD_VALUE_ERR, error);
+  }
+  Bcd hiDigits;
+  const Bcd loDigits =
+    bcd_multiply_wide(x.mantissa, y.mantissa, &hiDigits, NULL);
+
+  // as hi:lo (the double shift is 0 when a Bcd has 16 digits)
+  const unsigned long long lo = loDigits |
+    (unsigned long long)hiDigits << (MAX_BCD_DIGITS*BCD_BITS - 1) << 1;
+  const unsigned long long hi = (MAX_BCD_DIGITS == 16) ? hiDigits : 0;
+
+  const int productScale = x.scale + y.scale;
+  bool isOverflow = false;
+  Bcd mantissa;
+  if (scale >= productScale) {
+    mantissa = round_shift_right(hi, lo, 0, &isOverflow);
+    mantissa = shift_left_digits(mantissa, scale - productScale, &isOverflow);
+  }
+  else {
+    mantissa = round_shift_right(hi, lo, productScale - scale, &isOverflow);
+  }
+  return make_fixed_checked(mantissa, scale, x.isNegative != y.isNegative,
+                            isOverflow, error);
+}
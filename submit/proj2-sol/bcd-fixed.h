@@ -0,0 +1,70 @@
+
+
+#ifndef BCD_FIXED_H_
+#define BCD_FIXED_H_
+
+#include "bcd.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/** Signed decimal fixed-point number: the value is
+ *  (isNegative ? -1 : 1) * mantissa / 10**scale.
+ *
+ *  Valid values have a mantissa without any BCD digit > 9 and
+ *  0 <= scale <= MAX_BCD_DIGITS; results are never negative zero.
+ */
+typedef struct {
+  Bcd mantissa;           /** magnitude as packed BCD digits */
+  int scale;              /** # of digits after the decimal point */
+  bool isNegative;        /** sign */
+} BcdFixed;
+
+enum {
+  //buffer size needed by bcd_fixed_to_str(): sign, "0.", digits, \0
+  BCD_FIXED_BUF_SIZE = MAX_BCD_DIGITS + 4
+};
+
+//All of the following functions which return a BcdFixed return 0
+//(with scale 0) on error.  If error is not NULL, they set *error to
+//BAD_VALUE_ERR if an argument is not a valid BcdFixed or a requested
+//scale is out of range, OVERFLOW_ERR if the exact or rounded result
+//has more than MAX_BCD_DIGITS digits, otherwise *error is unchanged.
+//
+//Whenever digits are dropped, the result is rounded half to even
+//(banker's rounding): 0.125 => 0.12 but 0.135 => 0.14.
+
+/** Return the fixed-point number given by an optionally signed
+ *  decimal number with an optional fraction (like "-12.50") at the
+ *  start of s.  The scale is the # of digits given after the '.'.
+ *  Sets *p to point to the first char after the number (to s if there
+ *  is no number).
+ */
+BcdFixed str_to_bcd_fixed(const char *s, const char **p, BcdError *error);
+
+/** Convert x to a NUL-terminated string in buf[] with exactly
+ *  x.scale digits after the decimal point.  Never write more than
+ *  bufSize characters into buf.  The return value is the number of
+ *  characters written (excluding the terminating NUL).
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if x is not
+ *  valid, OVERFLOW_ERR if bufSize is less than BCD_FIXED_BUF_SIZE,
+ *  otherwise *error is unchanged.
+ */
+int bcd_fixed_to_str(BcdFixed x, char buf[], size_t bufSize,
+                     BcdError *error);
+
+/** Return x with scale digits after the decimal point. */
+BcdFixed bcd_fixed_rescale(BcdFixed x, int scale, BcdError *error);
+
+/** Return x + y with the larger of their scales. */
+BcdFixed bcd_fixed_add(BcdFixed x, BcdFixed y, BcdError *error);
+
+/** Return x - y with the larger of their scales. */
+BcdFixed bcd_fixed_subtract(BcdFixed x, BcdFixed y, BcdError *error);
+
+/** Return x * y rounded to scale digits after the decimal point. */
+BcdFixed bcd_fixed_multiply(BcdFixed x, BcdFixed y, int scale,
+                            BcdError *error);
+
+#endif //ifndef BCD_FIXED_H_
@@ -0,0 +1,98 @@
+
+
+#ifndef BCD_SWAR_H_
+#define BCD_SWAR_H_
+
+//SIMD-within-a-register helpers which operate on all the BCD digits
+//packed into an unsigned long long at once.  A narrower Bcd is simply
+//zero-extended; its unused high digits then behave as leading 0's.
+
+/** bit 0 of every nybble */
+#define BCD_SWAR_ONES  0x1111111111111111ULL
+
+/** 6 in every nybble: the gap between a decimal and a hex digit carry */
+#define BCD_SWAR_SIXES 0x6666666666666666ULL
+
+/** 3 in every nybble: double dabble correction */
+#define BCD_SWAR_THREES 0x3333333333333333ULL
+
+/** bit 3 of every nybble */
+#define BCD_SWAR_EIGHTS 0x8888888888888888ULL
+
+/** 9 in every nybble: subtracting from it gives the 9's complement */
+#define BCD_SWAR_NINES 0x9999999999999999ULL
+
+/** # of BCD digits in an unsigned long long */
+#define BCD_SWAR_DIGITS 16
+
+/** Return non-zero iff some nybble of x is not a valid BCD digit; the
+ *  result has bit 0 set of every nybble which is > 9.  A nybble is > 9
+ *  iff its bit 3 is set together with bit 2 or bit 1.
+ */
+static inline unsigned long long
+bcd_swar_bad_digits(unsigned long long x)
+{
+  return (x >> 3) & ((x >> 2) | (x >> 1)) & BCD_SWAR_ONES;
+}
+
+/** Return packed BCD x + y + carryIn, where x and y must be valid
+ *  packed BCD and carryIn is 0 or 1.  Sets *carryOut to the decimal
+ *  carry out of the most-significant digit.
+ *
+ *  Adding 6 to every digit of x makes a decimal carry out of a digit
+ *  coincide with a binary carry out of its nybble.  The carries into
+ *  each nybble are recovered from sum ^ x ^ y; digits which did not
+ *  carry still hold the extra 6 and have it subtracted (which cannot
+ *  borrow since such a nybble is >= 6).
+ */
+static inline unsigned long long
+bcd_swar_add(unsigned long long x, unsigned long long y,
+             unsigned carryIn, unsigned *carryOut)
+{
+  const unsigned long long t1 = x + BCD_SWAR_SIXES;
+  const unsigned long long t2 = y + carryIn;
+  const unsigned long long sum = t1 + t2;
+  const unsigned carry = sum < t1;
+  const unsigned long long carries = sum ^ t1 ^ t2;
+  const unsigned long long noCarry =
+    ~((carries >> 4) | ((unsigned long long)carry << 60)) & BCD_SWAR_ONES;
+  *carryOut = carry;
+  return sum - ((noCarry << 2) | (noCarry << 1));
+}
+
+/** Return packed BCD x - y - borrowIn, where x and y must be valid
+ *  packed BCD and borrowIn is 0 or 1.  Sets *borrowOut to 1 iff the
+ *  result wrapped around (x < y + borrowIn), i.e. returns the 10's
+ *  complement x + (NINES - y) + !borrowIn.
+ */
+static inline unsigned long long
+bcd_swar_sub(unsigned long long x, unsigned long long y,
+             unsigned borrowIn, unsigned *borrowOut)
+{
+  unsigned carry;
+  unsigned long long diff =
+    bcd_swar_add(x, BCD_SWAR_NINES - y, !borrowIn, &carry);
+  *borrowOut = !carry;
+  return diff;
+}
+
+/** Double dabble step: add 3 to every digit of x which is >= 5 so
+ *  that a following left shift carries decimally.  Exactly the digits
+ *  >= 5 reach bit 3 when 3 is added.
+ */
+static inline unsigned long long
+bcd_swar_dabble_add3(unsigned long long x)
+{
+  return x + (((x + BCD_SWAR_THREES) & BCD_SWAR_EIGHTS) >> 3) * 3;
+}
+
+/** Reverse double dabble step: after a right shift, subtract 3 from
+ *  every nybble of x which is >= 8 (it received a decimal 10 / 2).
+ */
+static inline unsigned long long
+bcd_swar_dabble_sub3(unsigned long long x)
+{
+  return x - ((x & BCD_SWAR_EIGHTS) >> 3) * 3;
+}
+
+#endif //ifndef BCD_SWAR_H_
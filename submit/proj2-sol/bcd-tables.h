@@ -0,0 +1,47 @@
+
+
+#ifndef BCD_TABLES_H_
+#define BCD_TABLES_H_
+
+#include "bcd.h"
+
+//Constant tables for the BCD conversions, generated at compile time
+//by the preprocessor; they do not depend on BCD_BASE beyond being
+//indexed by at most MAX_BCD_DIGITS.  Include only from .c files:
+//each includer gets its own static copy.
+
+//10**i for 0 <= i < BCD_POW10_SIZE (10**19 is the largest power of
+//10 which fits in an unsigned long long); BCD_MAX_BINARY is
+//BCD_POW10[MAX_BCD_DIGITS] - 1
+enum { BCD_POW10_SIZE = 20 };
+#define BCD_POW10_ROW(p) \
+  p##ULL, p##0ULL, p##00ULL, p##000ULL, p##0000ULL
+static const unsigned long long BCD_POW10[BCD_POW10_SIZE] = {
+  BCD_POW10_ROW(1), BCD_POW10_ROW(100000), BCD_POW10_ROW(10000000000),
+  BCD_POW10_ROW(1000000000000000),
+};
+
+//packed BCD byte for each binary value 0 ... 99
+#define BIN_TO_BCD2_ROW(t) \
+  (t)<<4|0, (t)<<4|1, (t)<<4|2, (t)<<4|3, (t)<<4|4, \
+  (t)<<4|5, (t)<<4|6, (t)<<4|7, (t)<<4|8, (t)<<4|9
+static const unsigned char BIN_TO_BCD2[100] = {
+  BIN_TO_BCD2_ROW(0), BIN_TO_BCD2_ROW(1), BIN_TO_BCD2_ROW(2),
+  BIN_TO_BCD2_ROW(3), BIN_TO_BCD2_ROW(4), BIN_TO_BCD2_ROW(5),
+  BIN_TO_BCD2_ROW(6), BIN_TO_BCD2_ROW(7), BIN_TO_BCD2_ROW(8),
+  BIN_TO_BCD2_ROW(9),
+};
+
+//binary value of each valid packed BCD byte 0x00 ... 0x99; entries
+//for bytes containing a digit > 9 are 0 and must not be used
+#define BCD2_TO_BIN_ROW(t) \
+  (t)*10+0, (t)*10+1, (t)*10+2, (t)*10+3, (t)*10+4, \
+  (t)*10+5, (t)*10+6, (t)*10+7, (t)*10+8, (t)*10+9, 0, 0, 0, 0, 0, 0
+static const unsigned char BCD2_TO_BIN[256] = {
+  BCD2_TO_BIN_ROW(0), BCD2_TO_BIN_ROW(1), BCD2_TO_BIN_ROW(2),
+  BCD2_TO_BIN_ROW(3), BCD2_TO_BIN_ROW(4), BCD2_TO_BIN_ROW(5),
+  BCD2_TO_BIN_ROW(6), BCD2_TO_BIN_ROW(7), BCD2_TO_BIN_ROW(8),
+  BCD2_TO_BIN_ROW(9),
+};
+
+#endif //ifndef BCD_TABLES_H_
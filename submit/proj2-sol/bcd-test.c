@@ -1,6 +1,9 @@
 
 
 #include "bcd.h"
+#include "bcd-batch.h"
+#include "bcd-big.h"
+#include "bcd-fixed.h"
 
 #include "check-extra.h"
 
@@ -458,6 +461,84 @@ START_TEST(str_to_bcd_overflow)
 }
 END_TEST
 
+START_TEST(str_to_bcd_leading_zeros)
+{
+  char str[BCD_BUF_SIZE + 24];
+  sprintf(str, " 00000000000000000000%s+", DATA.max.str);
+  TEST_TRACE("str_to_bcd(\"%s\"): leading zeros", str);
+
+  const char *p;
+  BcdError err = OK_ERR;
+  Bcd result = str_to_bcd(str, &p, &err);
+
+  BCD_TRACE(result, DATA.max.bcd);
+  ck_assert_bcd_eq(result, DATA.max.bcd);
+
+  CHAR_TRACE(*p, '+');
+  ck_assert_int_eq(*p, '+');
+
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+}
+END_TEST
+
+START_TEST(str_to_bcd_no_digits)
+{
+  const char *str = "  x1";
+  TEST_TRACE("str_to_bcd(\"%s\"): no digits", str);
+
+  const char *p;
+  BcdError err = OK_ERR;
+  Bcd result = str_to_bcd(str, &p, &err);
+
+  BCD_TRACE(result, (Bcd)0);
+  ck_assert_bcd_eq(result, 0);
+
+  ck_assert_int_eq(p - str, 0);
+
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+}
+END_TEST
+
+START_TEST(str_to_bcd_plus_sign)
+{
+  const char *str = " +5 + 3";
+  TEST_TRACE("str_to_bcd(\"%s\"): leading +", str);
+
+  const char *p;
+  BcdError err = OK_ERR;
+  Bcd result = str_to_bcd(str, &p, &err);
+
+  BCD_TRACE(result, (Bcd)0x5);
+  ck_assert_bcd_eq(result, 0x5);
+
+  ck_assert_int_eq(p - str, 3);
+
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+}
+END_TEST
+
+START_TEST(str_to_bcd_minus_sign)
+{
+  const char *str = "-5";
+  TEST_TRACE("str_to_bcd(\"%s\"): leading -", str);
+
+  const char *p;
+  BcdError err = OK_ERR;
+  Bcd result = str_to_bcd(str, &p, &err);
+
+  BCD_TRACE(result, (Bcd)0);
+  ck_assert_bcd_eq(result, 0);
+
+  ck_assert_int_eq(p - str, 0);
+
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+}
+END_TEST
+
 
 __attribute__((unused))
 static void
@@ -468,6 +549,10 @@ add_str_to_bcd_tests(Suite *suite)
   tcase_add_test(strToBcd, str_to_bcd_not_nul_terminator);
   tcase_add_test(strToBcd, str_to_bcd_max);
   tcase_add_test(strToBcd, str_to_bcd_overflow);
+  tcase_add_test(strToBcd, str_to_bcd_leading_zeros);
+  tcase_add_test(strToBcd, str_to_bcd_no_digits);
+  tcase_add_test(strToBcd, str_to_bcd_plus_sign);
+  tcase_add_test(strToBcd, str_to_bcd_minus_sign);
   suite_add_tcase(suite, strToBcd);
 }
 
@@ -552,6 +637,28 @@ START_TEST(bcd_to_str_overflow)
 }
 END_TEST
 
+START_TEST(bcd_to_str_overflow_no_write)
+{
+
+  TEST_TRACE("bcd_to_str(0x%" BCD_FORMAT_MODIFIER "x): overflow "
+             "does not write past buffer", DATA.max.bcd);
+
+  BcdError err = OK_ERR;
+  char str[BCD_BUF_SIZE];
+  memset(str, 'x', sizeof(str));
+
+  int n = bcd_to_str(DATA.max.bcd, str, sizeof(str) - 1, &err);
+
+  INT_TRACE(n, 0);
+  ck_assert_int_eq(n, 0);
+  CHAR_TRACE(str[sizeof(str) - 1], 'x');
+  ck_assert_int_eq(str[sizeof(str) - 1], 'x');
+
+  ERR_TRACE(err, OVERFLOW_ERR);
+  ck_assert_int_eq(err, OVERFLOW_ERR);
+}
+END_TEST
+
 START_TEST(bcd_to_str_bad_value)
 {
   TEST_TRACE("bcd_to_str(0x%" BCD_FORMAT_MODIFIER "x) with bad value",
@@ -576,6 +683,7 @@ add_bcd_to_str_tests(Suite *suite)
   tcase_add_test(bcdToStr, bcd_to_str_max);
   tcase_add_test(bcdToStr, bcd_to_str_zero);
   tcase_add_test(bcdToStr, bcd_to_str_overflow);
+  tcase_add_test(bcdToStr, bcd_to_str_overflow_no_write);
   tcase_add_test(bcdToStr, bcd_to_str_bad_value);
   suite_add_tcase(suite, bcdToStr);
 }
@@ -677,6 +785,40 @@ START_TEST(bcd_add_overflow2)
 }
 END_TEST
 
+START_TEST(bcd_add_ripple_carry)
+{
+  Bcd arg1 = DATA.maxHalfTrunc.bcd;
+  TEST_TRACE("bcd_add(0x%" BCD_FORMAT_MODIFIER "x, 0x%"
+             BCD_FORMAT_MODIFIER "x): "
+             "carry through all digits", arg1, (Bcd)0x1);
+
+  BcdError err = OK_ERR;
+  Bcd sum = bcd_add(arg1, 0x1, &err);
+
+  Bcd expected = DATA.maxHalfRound.bcd;
+  BCD_TRACE(sum, expected);
+  ck_assert_bcd_eq(sum, expected);
+
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+}
+END_TEST
+
+START_TEST(bcd_add_null_error)
+{
+  TEST_TRACE("bcd_add(0x%" BCD_FORMAT_MODIFIER "x, 0x%"
+             BCD_FORMAT_MODIFIER "x, NULL): "
+             "overflow", DATA.max.bcd, (Bcd)0x1);
+
+  bcd_add(DATA.max.bcd, 0x1, NULL);
+  bcd_add(DATA.badVal.bcd, 0x1, NULL);
+  Bcd sum = bcd_add(DATA.max4.bcd, 0x4, NULL);
+
+  BCD_TRACE(sum, DATA.max.bcd);
+  ck_assert_bcd_eq(sum, DATA.max.bcd);
+}
+END_TEST
+
 __attribute__((unused))
 static void
 add_bcd_add_tests(Suite *suite)
@@ -688,6 +830,8 @@ add_bcd_add_tests(Suite *suite)
   tcase_add_test(bcdAdd, bcd_add_bad_value2);
   tcase_add_test(bcdAdd, bcd_add_overflow1);
   tcase_add_test(bcdAdd, bcd_add_overflow2);
+  tcase_add_test(bcdAdd, bcd_add_ripple_carry);
+  tcase_add_test(bcdAdd, bcd_add_null_error);
   suite_add_tcase(suite, bcdAdd);
 }
 
@@ -789,6 +933,63 @@ START_TEST(bcd_multiply_overflow)
 }
 END_TEST
 
+START_TEST(bcd_multiply_max_overflow)
+{
+  TEST_TRACE("bcd_multiply(0x%" BCD_FORMAT_MODIFIER "x, 0x%"
+             BCD_FORMAT_MODIFIER "x): overflow",
+             DATA.max.bcd, DATA.max.bcd);
+
+  BcdError err = OK_ERR;
+  Bcd product = bcd_multiply(DATA.max.bcd, DATA.max.bcd, &err);
+
+  ERR_TRACE(err, OVERFLOW_ERR);
+  ck_assert_int_eq(err, OVERFLOW_ERR);
+  ck_assert_bcd_eq(product, 0);
+}
+END_TEST
+
+START_TEST(bcd_multiply_wide_max)
+{
+  TEST_TRACE("bcd_multiply_wide(0x%" BCD_FORMAT_MODIFIER "x, 0x%"
+             BCD_FORMAT_MODIFIER "x)",
+             DATA.max.bcd, DATA.max.bcd);
+
+  //99...9 * 99...9 == 99...98 00...01
+  BcdError err = OK_ERR;
+  Bcd hi;
+  Bcd lo = bcd_multiply_wide(DATA.max.bcd, DATA.max.bcd, &hi, &err);
+
+  BCD_TRACE(lo, (Bcd)0x1);
+  ck_assert_bcd_eq(lo, 0x1);
+  BCD_TRACE(hi, DATA.max4.bcd + 3);
+  ck_assert_bcd_eq(hi, DATA.max4.bcd + 3);
+
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+}
+END_TEST
+
+START_TEST(bcd_multiply_wide_no_hi)
+{
+  TEST_TRACE("bcd_multiply_wide(0x%" BCD_FORMAT_MODIFIER "x, 0x%"
+             BCD_FORMAT_MODIFIER "x)",
+             DATA.maxHalfTrunc.bcd, (Bcd)0x2);
+
+  BcdError err = OK_ERR;
+  Bcd hi;
+  Bcd lo = bcd_multiply_wide(DATA.maxHalfTrunc.bcd, 0x2, &hi, &err);
+
+  BCD_TRACE(lo, DATA.max4.bcd + 3);
+  ck_assert_bcd_eq(lo, DATA.max4.bcd + 3);
+  BCD_TRACE(hi, (Bcd)0);
+  ck_assert_bcd_eq(hi, 0);
+
+  bcd_multiply_wide(DATA.badVal.bcd, 0x2, &hi, &err);
+  ERR_TRACE(err, BAD_VALUE_ERR);
+  ck_assert_int_eq(err, BAD_VALUE_ERR);
+}
+END_TEST
+
 __attribute__((unused))
 static void
 add_bcd_multiply_tests(Suite *suite)
@@ -800,6 +1001,9 @@ add_bcd_multiply_tests(Suite *suite)
   tcase_add_test(bcdMultiply, bcd_multiply_bad_value2);
   tcase_add_test(bcdMultiply, bcd_multiply_no_overflow);
   tcase_add_test(bcdMultiply, bcd_multiply_overflow);
+  tcase_add_test(bcdMultiply, bcd_multiply_max_overflow);
+  tcase_add_test(bcdMultiply, bcd_multiply_wide_max);
+  tcase_add_test(bcdMultiply, bcd_multiply_wide_no_hi);
   suite_add_tcase(suite, bcdMultiply);
 }
 
@@ -947,6 +1151,675 @@ add_bcd_multiop_tests(Suite *suite)
   suite_add_tcase(suite, multiop);
 
 }
+/*************************** BcdBig Tests ******************************/
+
+//digits spanning 3 64-bit limbs
+#define BIG_X "12345678901234567890123456789012345678"
+#define BIG_Y "98765432109876543210987654321098765432"
+#define BIG_X_PLUS_Y "111111111011111111101111111110111111110"
+#define BIG_NINES_MINUS_X "87654321098765432109876543210987654321"
+#define BIG_X_TIMES_Y \
+  "1219326311370217952261850327338667885854747751864349946654322511812221002896"
+
+/** Parse s into big, checking that all of s is consumed */
+static void
+str_to_big_ok(const char *s, BcdBig *big)
+{
+  const char *p;
+  str_to_bcd_big(s, &p, big);
+  CHAR_TRACE(*p, '\0');
+  ck_assert_int_eq(*p, '\0');
+}
+
+/** Check that big formats as the string expected */
+static void
+ck_big_str(const BcdBig *big, const char *expected)
+{
+  char buf[128];
+  BcdError err = OK_ERR;
+  int n = bcd_big_to_str(big, buf, sizeof(buf), &err);
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+  STR_TRACE(buf, expected);
+  ck_assert_str_eq(buf, expected);
+  ck_assert_int_eq(n, strlen(expected));
+}
+
+START_TEST(bcd_big_str_round_trip)
+{
+  TEST_TRACE("bcd_big_str_round_trip: \"%s\"", BIG_X);
+  BcdBig x;
+  init_bcd_big(&x);
+  str_to_big_ok("000" BIG_X, &x);
+  ck_assert_int_eq(bcd_big_n_digits(&x), strlen(BIG_X));
+  ck_big_str(&x, BIG_X);
+  free_bcd_big(&x);
+}
+END_TEST
+
+START_TEST(str_to_bcd_big_sign)
+{
+  TEST_TRACE("str_to_bcd_big: \" +007 \", \" -7\", \"\"");
+  BcdBig x;
+  init_bcd_big(&x);
+  const char *str = " +007 ";
+  const char *p;
+  str_to_bcd_big(str, &p, &x);
+  ck_assert_int_eq(p - str, 5);
+  ck_big_str(&x, "7");
+
+  str = " -7";
+  str_to_bcd_big(str, &p, &x);
+  ck_assert_int_eq(p - str, 0);
+  ck_big_str(&x, "0");
+
+  str = "";
+  str_to_bcd_big(str, &p, &x);
+  ck_assert_int_eq(p - str, 0);
+  ck_big_str(&x, "0");
+  free_bcd_big(&x);
+}
+END_TEST
+
+START_TEST(bcd_big_to_str_overflow)
+{
+  TEST_TRACE("bcd_big_to_str_overflow: \"%s\"", BIG_X);
+  BcdBig x;
+  init_bcd_big(&x);
+  str_to_big_ok(BIG_X, &x);
+  char buf[sizeof(BIG_X) + 1];
+  memset(buf, 'x', sizeof(buf));
+  BcdError err = OK_ERR;
+  bcd_big_to_str(&x, buf, sizeof(BIG_X) - 1, &err);
+  ERR_TRACE(err, OVERFLOW_ERR);
+  ck_assert_int_eq(err, OVERFLOW_ERR);
+  ck_assert_int_eq(buf[sizeof(BIG_X) - 1], 'x');
+  free_bcd_big(&x);
+}
+END_TEST
+
+START_TEST(bcd_big_bcd_round_trip)
+{
+  TEST_TRACE("bcd_big_bcd_round_trip: 0x%" BCD_FORMAT_MODIFIER "x",
+             DATA.max.bcd);
+  BcdBig x;
+  init_bcd_big(&x);
+  BcdError err = OK_ERR;
+  bcd_to_bcd_big(DATA.max.bcd, &x, &err);
+  ck_big_str(&x, DATA.max.str);
+  Bcd bcd = bcd_big_to_bcd(&x, &err);
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+  BCD_TRACE(bcd, DATA.max.bcd);
+  ck_assert_bcd_eq(bcd, DATA.max.bcd);
+
+  bcd_to_bcd_big(DATA.badVal.bcd, &x, &err);
+  ERR_TRACE(err, BAD_VALUE_ERR);
+  ck_assert_int_eq(err, BAD_VALUE_ERR);
+
+  err = OK_ERR;
+  str_to_big_ok(BIG_X, &x);
+  bcd_big_to_bcd(&x, &err);
+  ERR_TRACE(err, OVERFLOW_ERR);
+  ck_assert_int_eq(err, OVERFLOW_ERR);
+  free_bcd_big(&x);
+}
+END_TEST
+
+START_TEST(bcd_big_add_carry)
+{
+  TEST_TRACE("bcd_big_add_carry: \"%s\" + \"%s\"", BIG_X, BIG_Y);
+  BcdBig x, y, sum;
+  init_bcd_big(&x); init_bcd_big(&y); init_bcd_big(&sum);
+  str_to_big_ok(BIG_X, &x);
+  str_to_big_ok(BIG_Y, &y);
+  BcdError err = OK_ERR;
+  bcd_big_add(&x, &y, &sum, &err);
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+  ck_big_str(&sum, BIG_X_PLUS_Y);
+
+  //carry ripples through every limb into a new one
+  str_to_big_ok("99999999999999999999999999999999999999999999999999", &x);
+  str_to_big_ok("1", &y);
+  bcd_big_add(&x, &y, &x, &err);
+  ck_big_str(&x, "100000000000000000000000000000000000000000000000000");
+  free_bcd_big(&x); free_bcd_big(&y); free_bcd_big(&sum);
+}
+END_TEST
+
+START_TEST(bcd_big_subtract_borrow)
+{
+  TEST_TRACE("bcd_big_subtract_borrow: 10**38 - 1 - \"%s\"", BIG_X);
+  BcdBig x, y, diff;
+  init_bcd_big(&x); init_bcd_big(&y); init_bcd_big(&diff);
+  str_to_big_ok("100000000000000000000000000000000000000", &x);
+  str_to_big_ok(BIG_X, &y);
+  BcdError err = OK_ERR;
+  bcd_big_subtract(&x, &y, &diff, &err);
+  str_to_big_ok("1", &y);
+  bcd_big_subtract(&diff, &y, &diff, &err);
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+  ck_big_str(&diff, BIG_NINES_MINUS_X);
+
+  bcd_big_subtract(&y, &x, &diff, &err);
+  ERR_TRACE(err, OVERFLOW_ERR);
+  ck_assert_int_eq(err, OVERFLOW_ERR);
+  ck_big_str(&diff, "0");
+  free_bcd_big(&x); free_bcd_big(&y); free_bcd_big(&diff);
+}
+END_TEST
+
+START_TEST(bcd_big_multiply_long)
+{
+  TEST_TRACE("bcd_big_multiply_long: \"%s\" * \"%s\"", BIG_X, BIG_Y);
+  BcdBig x, y, product;
+  init_bcd_big(&x); init_bcd_big(&y); init_bcd_big(&product);
+  str_to_big_ok(BIG_X, &x);
+  str_to_big_ok(BIG_Y, &y);
+  BcdError err = OK_ERR;
+  bcd_big_multiply(&x, &y, &product, &err);
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+  ck_big_str(&product, BIG_X_TIMES_Y);
+
+  bcd_big_multiply(&x, &y, &x, &err);
+  ck_big_str(&x, BIG_X_TIMES_Y);
+  str_to_big_ok("0", &y);
+  bcd_big_multiply(&x, &y, &x, &err);
+  ck_big_str(&x, "0");
+  free_bcd_big(&x); free_bcd_big(&y); free_bcd_big(&product);
+}
+END_TEST
+
+START_TEST(bcd_big_compare_order)
+{
+  TEST_TRACE("bcd_big_compare_order: \"%s\" vs \"%s\"", BIG_X, BIG_Y);
+  BcdBig x, y;
+  init_bcd_big(&x); init_bcd_big(&y);
+  str_to_big_ok(BIG_X, &x);
+  str_to_big_ok(BIG_Y, &y);
+  ck_assert_int_lt(bcd_big_compare(&x, &y), 0);
+  ck_assert_int_gt(bcd_big_compare(&y, &x), 0);
+  bcd_big_copy(&y, &x);
+  ck_assert_int_eq(bcd_big_compare(&x, &y), 0);
+  str_to_big_ok("9", &y);
+  ck_assert_int_gt(bcd_big_compare(&x, &y), 0);
+  free_bcd_big(&x); free_bcd_big(&y);
+}
+END_TEST
+
+__attribute__((unused))
+static void
+add_bcd_big_tests(Suite *suite)
+{
+  TCase *bcdBig = tcase_create("bcd_big");
+  tcase_add_test(bcdBig, bcd_big_str_round_trip);
+  tcase_add_test(bcdBig, str_to_bcd_big_sign);
+  tcase_add_test(bcdBig, bcd_big_to_str_overflow);
+  tcase_add_test(bcdBig, bcd_big_bcd_round_trip);
+  tcase_add_test(bcdBig, bcd_big_add_carry);
+  tcase_add_test(bcdBig, bcd_big_subtract_borrow);
+  tcase_add_test(bcdBig, bcd_big_multiply_long);
+  tcase_add_test(bcdBig, bcd_big_compare_order);
+  suite_add_tcase(suite, bcdBig);
+}
+
+/************************** Batch API Tests ****************************/
+
+//not a multiple of any vector width, so scalar tails are exercised too
+enum { BATCH_N = 11 };
+
+/** Fill infos[BATCH_N] cycling through the valid test values, with
+ *  err placed at index errIndex.
+ */
+static void
+fillBatch(const BcdInfo *infos[], const BcdInfo *err, int errIndex)
+{
+  const BcdInfo *valid[] = {
+    &DATA.zero, &DATA.consecutive, &DATA.max, &DATA.max4,
+    &DATA.maxHalfTrunc, &DATA.maxHalfRound,
+  };
+  const int nValid = sizeof(valid)/sizeof(valid[0]);
+  for (int i = 0; i < BATCH_N; i++) infos[i] = valid[i % nValid];
+  infos[errIndex] = err;
+}
+
+START_TEST(batch_binary_to_bcd)
+{
+  TEST_TRACE("binary_to_bcd_n(): overflow at index 9");
+  const BcdInfo *infos[BATCH_N];
+  fillBatch(infos, &DATA.overflow, 9);
+  Binary in[BATCH_N];
+  Bcd out[BATCH_N];
+  BcdError errs[BATCH_N];
+  for (int i = 0; i < BATCH_N; i++) in[i] = infos[i]->binary;
+
+  unsigned summary = binary_to_bcd_n(in, out, BATCH_N, errs);
+
+  ck_assert_int_eq(summary, BCD_ERR_BIT(OVERFLOW_ERR));
+  for (int i = 0; i < BATCH_N; i++) {
+    const int isErr = (i == 9);
+    BCD_TRACE(out[i], isErr ? 0 : infos[i]->bcd);
+    ck_assert_bcd_eq(out[i], isErr ? 0 : infos[i]->bcd);
+    ERR_TRACE(errs[i], isErr ? OVERFLOW_ERR : OK_ERR);
+    ck_assert_int_eq(errs[i], isErr ? OVERFLOW_ERR : OK_ERR);
+  }
+}
+END_TEST
+
+START_TEST(batch_bcd_to_binary)
+{
+  TEST_TRACE("bcd_to_binary_n(): bad value at index 4");
+  const BcdInfo *infos[BATCH_N];
+  fillBatch(infos, &DATA.badVal, 4);
+  Bcd in[BATCH_N];
+  Binary out[BATCH_N];
+  BcdError errs[BATCH_N];
+  for (int i = 0; i < BATCH_N; i++) in[i] = infos[i]->bcd;
+
+  unsigned summary = bcd_to_binary_n(in, out, BATCH_N, errs);
+
+  ck_assert_int_eq(summary, BCD_ERR_BIT(BAD_VALUE_ERR));
+  for (int i = 0; i < BATCH_N; i++) {
+    const int isErr = (i == 4);
+    BCD_TRACE(out[i], isErr ? 0 : infos[i]->binary);
+    ck_assert_bcd_eq(out[i], isErr ? 0 : infos[i]->binary);
+    ERR_TRACE(errs[i], isErr ? BAD_VALUE_ERR : OK_ERR);
+    ck_assert_int_eq(errs[i], isErr ? BAD_VALUE_ERR : OK_ERR);
+  }
+}
+END_TEST
+
+START_TEST(batch_bcd_add)
+{
+  TEST_TRACE("bcd_add_n(): matches bcd_add() incl. errors");
+  const BcdInfo *infos[BATCH_N];
+  fillBatch(infos, &DATA.badVal, 0);
+  Bcd x[BATCH_N], y[BATCH_N], out[BATCH_N];
+  BcdError errs[BATCH_N];
+  for (int i = 0; i < BATCH_N; i++) {
+    x[i] = infos[i]->bcd;
+    y[i] = infos[BATCH_N - 1 - i]->bcd;
+  }
+
+  unsigned summary = bcd_add_n(x, y, out, BATCH_N, errs);
+
+  unsigned expectedSummary = 0;
+  for (int i = 0; i < BATCH_N; i++) {
+    BcdError err = OK_ERR;
+    Bcd sum = bcd_add(x[i], y[i], &err);
+    if (err != OK_ERR) expectedSummary |= BCD_ERR_BIT(err);
+    BCD_TRACE(out[i], sum);
+    ck_assert_bcd_eq(out[i], sum);
+    ERR_TRACE(errs[i], err);
+    ck_assert_int_eq(errs[i], err);
+  }
+  ck_assert_int_eq(summary,
+                   BCD_ERR_BIT(BAD_VALUE_ERR) | BCD_ERR_BIT(OVERFLOW_ERR));
+  ck_assert_int_eq(summary, expectedSummary);
+
+  //in place, without per-element errors
+  summary = bcd_add_n(x, y, x, BATCH_N, NULL);
+  ck_assert_int_eq(summary, expectedSummary);
+  ck_assert_bcd_eq(x[1], out[1]);
+}
+END_TEST
+
+START_TEST(batch_bcd_multiply)
+{
+  TEST_TRACE("bcd_multiply_n(): x * 1, maxHalfRound * 2 overflows");
+  const BcdInfo *infos[BATCH_N];
+  fillBatch(infos, &DATA.badVal, 7);
+  Bcd x[BATCH_N], y[BATCH_N], out[BATCH_N];
+  BcdError errs[BATCH_N];
+  for (int i = 0; i < BATCH_N; i++) {
+    x[i] = infos[i]->bcd;
+    y[i] = 0x1;
+  }
+  x[2] = DATA.maxHalfRound.bcd;
+  y[2] = 0x2;
+  x[3] = DATA.maxHalfTrunc.bcd;
+  y[3] = 0x2;
+
+  unsigned summary = bcd_multiply_n(x, y, out, BATCH_N, errs);
+
+  ck_assert_int_eq(summary,
+                   BCD_ERR_BIT(BAD_VALUE_ERR) | BCD_ERR_BIT(OVERFLOW_ERR));
+  for (int i = 0; i < BATCH_N; i++) {
+    const BcdError err =
+      (i == 7) ? BAD_VALUE_ERR : (i == 2) ? OVERFLOW_ERR : OK_ERR;
+    const Bcd product =
+      (i == 3) ? DATA.max4.bcd + 3 : (err == OK_ERR) ? x[i] : 0;
+    BCD_TRACE(out[i], product);
+    ck_assert_bcd_eq(out[i], product);
+    ERR_TRACE(errs[i], err);
+    ck_assert_int_eq(errs[i], err);
+  }
+}
+END_TEST
+
+__attribute__((unused))
+static void
+add_bcd_batch_tests(Suite *suite)
+{
+  TCase *batch = tcase_create("bcd_batch");
+  tcase_add_test(batch, batch_binary_to_bcd);
+  tcase_add_test(batch, batch_bcd_to_binary);
+  tcase_add_test(batch, batch_bcd_add);
+  tcase_add_test(batch, batch_bcd_multiply);
+  suite_add_tcase(suite, batch);
+}
+
+/************************** BcdFixed Tests *****************************/
+
+//all values have at most 2 digits so that they fit every BCD_BASE
+
+/** Parse s as a BcdFixed, checking that all of s is consumed */
+static BcdFixed
+str_to_fixed_ok(const char *s)
+{
+  const char *p;
+  BcdError err = OK_ERR;
+  BcdFixed x = str_to_bcd_fixed(s, &p, &err);
+  CHAR_TRACE(*p, '\0');
+  ck_assert_int_eq(*p, '\0');
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+  return x;
+}
+
+/** Check that x formats as the string expected */
+static void
+ck_fixed_str(BcdFixed x, const char *expected)
+{
+  char buf[BCD_FIXED_BUF_SIZE];
+  BcdError err = OK_ERR;
+  int n = bcd_fixed_to_str(x, buf, sizeof(buf), &err);
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+  STR_TRACE(buf, expected);
+  ck_assert_str_eq(buf, expected);
+  ck_assert_int_eq(n, strlen(expected));
+}
+
+START_TEST(bcd_fixed_str_round_trip)
+{
+  TEST_TRACE("bcd_fixed_str_round_trip: \"-1.2\", \"0.05\", \"-0.0\"");
+  BcdFixed x = str_to_fixed_ok("-1.2");
+  BCD_TRACE(x.mantissa, (Bcd)0x12);
+  ck_assert_bcd_eq(x.mantissa, 0x12);
+  ck_assert_int_eq(x.scale, 1);
+  ck_assert_int_eq(x.isNegative, 1);
+  ck_fixed_str(x, "-1.2");
+  ck_fixed_str(str_to_fixed_ok("0.05"), "0.05");
+  ck_fixed_str(str_to_fixed_ok("-0.0"), "0.0");
+  ck_fixed_str(str_to_fixed_ok(".5"), "0.5");
+}
+END_TEST
+
+START_TEST(bcd_fixed_add_align)
+{
+  TEST_TRACE("bcd_fixed_add: \"0.5\" + \"0.25\"; \"0.5\" - \"0.75\"");
+  BcdError err = OK_ERR;
+  BcdFixed x = str_to_fixed_ok("0.5");
+  BcdFixed y = str_to_fixed_ok("0.25");
+  ck_fixed_str(bcd_fixed_add(x, y, &err), "0.75");
+  ck_fixed_str(bcd_fixed_subtract(x, str_to_fixed_ok("0.75"), &err),
+               "-0.25");
+  ck_fixed_str(bcd_fixed_add(str_to_fixed_ok("-2.5"), str_to_fixed_ok("2.5"),
+                             &err), "0.0");
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+}
+END_TEST
+
+START_TEST(bcd_fixed_add_cancel)
+{
+  TEST_TRACE("bcd_fixed_add: 1 - 0.0...01 with MAX_BCD_DIGITS fraction "
+             "digits");
+  //1 aligned to the scale of y does not fit, but 1 - y does
+  BcdError err = OK_ERR;
+  BcdFixed one = { 1, 0, false };
+  BcdFixed y = { 1, MAX_BCD_DIGITS, true };
+  BcdFixed z = bcd_fixed_add(one, y, &err);
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+  BCD_TRACE(z.mantissa, DATA.max.bcd);
+  ck_assert_bcd_eq(z.mantissa, DATA.max.bcd);
+  ck_assert_int_eq(z.scale, MAX_BCD_DIGITS);
+  ck_assert_int_eq(z.isNegative, 0);
+
+  one.isNegative = true;
+  y.isNegative = false;
+  z = bcd_fixed_add(y, one, &err);
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+  ck_assert_bcd_eq(z.mantissa, DATA.max.bcd);
+  ck_assert_int_eq(z.isNegative, 1);
+
+  //but 10 - 0.0...01 still needs MAX_BCD_DIGITS + 1 digits
+  BcdFixed ten = { 0x10, 0, false };
+  bcd_fixed_subtract(ten, y, &err);
+  ERR_TRACE(err, OVERFLOW_ERR);
+  ck_assert_int_eq(err, OVERFLOW_ERR);
+}
+END_TEST
+
+START_TEST(bcd_fixed_multiply_round)
+{
+  TEST_TRACE("bcd_fixed_multiply: banker's rounding of products");
+  BcdError err = OK_ERR;
+  BcdFixed x = str_to_fixed_ok("2.5");
+  ck_fixed_str(bcd_fixed_multiply(x, str_to_fixed_ok("3"), 1, &err), "7.5");
+  ck_fixed_str(bcd_fixed_multiply(x, str_to_fixed_ok("3"), 0, &err), "8");
+  ck_fixed_str(bcd_fixed_multiply(x, str_to_fixed_ok("-1"), 0, &err), "-2");
+  ck_fixed_str(bcd_fixed_multiply(str_to_fixed_ok("0.5"),
+                                  str_to_fixed_ok("0.5"), 1, &err), "0.2");
+  ck_fixed_str(bcd_fixed_multiply(str_to_fixed_ok("0.5"),
+                                  str_to_fixed_ok("0.7"), 1, &err), "0.4");
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+}
+END_TEST
+
+START_TEST(bcd_fixed_rescale_round)
+{
+  TEST_TRACE("bcd_fixed_rescale: banker's rounding and overflow");
+  BcdError err = OK_ERR;
+  ck_fixed_str(bcd_fixed_rescale(str_to_fixed_ok("0.15"), 1, &err), "0.2");
+  ck_fixed_str(bcd_fixed_rescale(str_to_fixed_ok("0.25"), 1, &err), "0.2");
+  ck_fixed_str(bcd_fixed_rescale(str_to_fixed_ok("-0.26"), 1, &err), "-0.3");
+  ck_fixed_str(bcd_fixed_rescale(str_to_fixed_ok("9.5"), 0, &err), "10");
+  ck_fixed_str(bcd_fixed_rescale(str_to_fixed_ok("0.04"), 1, &err), "0.0");
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+
+  BcdFixed max = { DATA.max.bcd, 0, false };
+  bcd_fixed_rescale(max, 1, &err);
+  ERR_TRACE(err, OVERFLOW_ERR);
+  ck_assert_int_eq(err, OVERFLOW_ERR);
+
+  err = OK_ERR;
+  BcdFixed bad = { DATA.badVal.bcd, 0, false };
+  bcd_fixed_add(bad, max, &err);
+  ERR_TRACE(err, BAD_VALUE_ERR);
+  ck_assert_int_eq(err, BAD_VALUE_ERR);
+}
+END_TEST
+
+__attribute__((unused))
+static void
+add_bcd_fixed_tests(Suite *suite)
+{
+  TCase *bcdFixed = tcase_create("bcd_fixed");
+  tcase_add_test(bcdFixed, bcd_fixed_str_round_trip);
+  tcase_add_test(bcdFixed, bcd_fixed_add_align);
+  tcase_add_test(bcdFixed, bcd_fixed_add_cancel);
+  tcase_add_test(bcdFixed, bcd_fixed_multiply_round);
+  tcase_add_test(bcdFixed, bcd_fixed_rescale_round);
+  suite_add_tcase(suite, bcdFixed);
+}
+
+/************** bcd_subtract(), bcd_compare(), bcd_divmod() ************/
+
+START_TEST(bcd_subtract_borrow)
+{
+  Bcd arg1 = DATA.maxHalfRound.bcd;
+  TEST_TRACE("bcd_subtract(0x%" BCD_FORMAT_MODIFIER "x, 0x%"
+             BCD_FORMAT_MODIFIER "x): "
+             "borrow through all digits", arg1, (Bcd)0x1);
+
+  BcdError err = OK_ERR;
+  Bcd diff = bcd_subtract(arg1, 0x1, &err);
+  BCD_TRACE(diff, DATA.maxHalfTrunc.bcd);
+  ck_assert_bcd_eq(diff, DATA.maxHalfTrunc.bcd);
+
+  diff = bcd_subtract(DATA.max.bcd, DATA.max4.bcd, &err);
+  BCD_TRACE(diff, (Bcd)0x4);
+  ck_assert_bcd_eq(diff, 0x4);
+
+  diff = bcd_subtract(DATA.consecutive.bcd, DATA.consecutive.bcd, &err);
+  BCD_TRACE(diff, (Bcd)0x0);
+  ck_assert_bcd_eq(diff, 0x0);
+
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+}
+END_TEST
+
+START_TEST(bcd_subtract_errors)
+{
+  TEST_TRACE("bcd_subtract(0x%" BCD_FORMAT_MODIFIER "x, 0x%"
+             BCD_FORMAT_MODIFIER "x): "
+             "negative difference", DATA.max4.bcd, DATA.max.bcd);
+
+  BcdError err = OK_ERR;
+  Bcd diff = bcd_subtract(DATA.max4.bcd, DATA.max.bcd, &err);
+  ck_assert_bcd_eq(diff, 0x0);
+  ERR_TRACE(err, OVERFLOW_ERR);
+  ck_assert_int_eq(err, OVERFLOW_ERR);
+
+  err = OK_ERR;
+  bcd_subtract(DATA.max.bcd, DATA.badVal.bcd, &err);
+  ERR_TRACE(err, BAD_VALUE_ERR);
+  ck_assert_int_eq(err, BAD_VALUE_ERR);
+}
+END_TEST
+
+START_TEST(bcd_compare_order)
+{
+  TEST_TRACE("bcd_compare(0x%" BCD_FORMAT_MODIFIER "x, 0x%"
+             BCD_FORMAT_MODIFIER "x)", DATA.max4.bcd, DATA.max.bcd);
+
+  BcdError err = OK_ERR;
+  ck_assert_int_lt(bcd_compare(DATA.max4.bcd, DATA.max.bcd, &err), 0);
+  ck_assert_int_gt(bcd_compare(DATA.max.bcd, DATA.max4.bcd, &err), 0);
+  ck_assert_int_eq(bcd_compare(DATA.consecutive.bcd,
+                               DATA.consecutive.bcd, &err), 0);
+  ck_assert_int_lt(bcd_compare(DATA.maxHalfTrunc.bcd,
+                               DATA.maxHalfRound.bcd, &err), 0);
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+
+  ck_assert_int_eq(bcd_compare(DATA.badVal.bcd, DATA.max.bcd, &err), 0);
+  ERR_TRACE(err, BAD_VALUE_ERR);
+  ck_assert_int_eq(err, BAD_VALUE_ERR);
+}
+END_TEST
+
+START_TEST(bcd_divmod_consecutive)
+{
+  Bcd divisors[] = { 0x1, 0x7, 0x56, DATA.maxHalfRound.bcd, DATA.max.bcd };
+  for (int i = 0; i < sizeof(divisors)/sizeof(divisors[0]); i++) {
+    Bcd y = divisors[i];
+    TEST_TRACE("bcd_divmod(0x%" BCD_FORMAT_MODIFIER "x, 0x%"
+               BCD_FORMAT_MODIFIER "x)", DATA.consecutive.bcd, y);
+
+    BcdError err = OK_ERR;
+    Bcd rem;
+    Bcd quotient = bcd_divmod(DATA.consecutive.bcd, y, &rem, &err);
+    Binary binaryY = bcd_to_binary(y, NULL);
+    Bcd expected = binary_to_bcd(DATA.consecutive.binary / binaryY, NULL);
+    Bcd expectedRem =
+      binary_to_bcd(DATA.consecutive.binary % binaryY, NULL);
+    BCD_TRACE(quotient, expected);
+    ck_assert_bcd_eq(quotient, expected);
+    BCD_TRACE(rem, expectedRem);
+    ck_assert_bcd_eq(rem, expectedRem);
+    ERR_TRACE(err, OK_ERR);
+    ck_assert_int_eq(err, OK_ERR);
+  }
+}
+END_TEST
+
+START_TEST(bcd_divmod_max)
+{
+  TEST_TRACE("bcd_divmod(0x%" BCD_FORMAT_MODIFIER "x, 0x%"
+             BCD_FORMAT_MODIFIER "x)", DATA.max.bcd, DATA.max4.bcd);
+
+  BcdError err = OK_ERR;
+  Bcd rem;
+  Bcd quotient = bcd_divmod(DATA.max.bcd, DATA.max4.bcd, &rem, &err);
+  BCD_TRACE(quotient, (Bcd)0x1);
+  ck_assert_bcd_eq(quotient, 0x1);
+  BCD_TRACE(rem, (Bcd)0x4);
+  ck_assert_bcd_eq(rem, 0x4);
+
+  quotient = bcd_divmod(DATA.max.bcd, DATA.maxHalfRound.bcd, NULL, &err);
+  BCD_TRACE(quotient, (Bcd)0x1);
+  ck_assert_bcd_eq(quotient, 0x1);
+  ERR_TRACE(err, OK_ERR);
+  ck_assert_int_eq(err, OK_ERR);
+
+  bcd_divmod(DATA.max.bcd, 0x0, &rem, &err);
+  ERR_TRACE(err, BAD_VALUE_ERR);
+  ck_assert_int_eq(err, BAD_VALUE_ERR);
+}
+END_TEST
+
+START_TEST(bcd_div_small_consecutive)
+{
+  unsigned divisors[] = { 1, 3, 7, 99, 1000003 };
+  for (int i = 0; i < sizeof(divisors)/sizeof(divisors[0]); i++) {
+    unsigned y = divisors[i];
+    TEST_TRACE("bcd_div_small(0x%" BCD_FORMAT_MODIFIER "x, %u)",
+               DATA.consecutive.bcd, y);
+
+    BcdError err = OK_ERR;
+    unsigned rem;
+    Bcd quotient = bcd_div_small(DATA.consecutive.bcd, y, &rem, &err);
+    Bcd expected = binary_to_bcd(DATA.consecutive.binary / y, NULL);
+    BCD_TRACE(quotient, expected);
+    ck_assert_bcd_eq(quotient, expected);
+    INT_TRACE(rem, DATA.consecutive.binary % y);
+    ck_assert_int_eq(rem, DATA.consecutive.binary % y);
+    ERR_TRACE(err, OK_ERR);
+    ck_assert_int_eq(err, OK_ERR);
+  }
+
+  BcdError err = OK_ERR;
+  bcd_div_small(DATA.badVal.bcd, 3, NULL, &err);
+  ERR_TRACE(err, BAD_VALUE_ERR);
+  ck_assert_int_eq(err, BAD_VALUE_ERR);
+}
+END_TEST
+
+__attribute__((unused))
+static void
+add_bcd_divide_tests(Suite *suite)
+{
+  TCase *bcdDivide = tcase_create("bcd_divide");
+  tcase_add_test(bcdDivide, bcd_subtract_borrow);
+  tcase_add_test(bcdDivide, bcd_subtract_errors);
+  tcase_add_test(bcdDivide, bcd_compare_order);
+  tcase_add_test(bcdDivide, bcd_divmod_consecutive);
+  tcase_add_test(bcdDivide, bcd_divmod_max);
+  tcase_add_test(bcdDivide, bcd_div_small_consecutive);
+  suite_add_tcase(suite, bcdDivide);
+}
+
 /*********************** Test Suite and Runner *************************/
 
 #define binary_to_bcd_test 0x1
@@ -956,13 +1829,18 @@ add_bcd_multiop_tests(Suite *suite)
 #define bcd_add_test 0x10
 #define bcd_multiply_test 0x20
 #define bcd_multiop_test 0x40
+#define bcd_big_test 0x80
+#define bcd_batch_test 0x100
+#define bcd_fixed_test 0x200
+#define bcd_divide_test 0x400
 
 #if TEST == 0
 #undef TEST
 #define TEST \
   (binary_to_bcd_test | bcd_to_binary_test | \
    str_to_bcd_test | bcd_to_str_test | \
-   bcd_add_test | bcd_multiply_test | bcd_multiop_test )
+   bcd_add_test | bcd_multiply_test | bcd_multiop_test | \
+   bcd_big_test | bcd_batch_test | bcd_fixed_test | bcd_divide_test )
 #endif
 
 static Suite *
@@ -991,6 +1869,18 @@ bcd_suite(const char *name)
   #if TEST & bcd_multiop_test
   add_bcd_multiop_tests(suite);
   #endif
+  #if TEST & bcd_big_test
+  add_bcd_big_tests(suite);
+  #endif
+  #if TEST & bcd_batch_test
+  add_bcd_batch_tests(suite);
+  #endif
+  #if TEST & bcd_fixed_test
+  add_bcd_fixed_tests(suite);
+  #endif
+  #if TEST & bcd_divide_test
+  add_bcd_divide_tests(suite);
+  #endif
 
   return suite;
 }
@@ -1,22 +1,31 @@
 
 
 #include "bcd.h"
+#include "bcd-swar.h"
+#include "bcd-tables.h"
 
 #include <assert.h>
 #include <ctype.h>
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <ctype.h>
 
-// Power
-unsigned long long power(unsigned long long base, unsigned int exp) {
-    unsigned long long i, result = 1;
-    for (i = 0; i < exp; i++)
-        result *= base;
-    return result;
- }
+#ifdef __SSE2__
+  #include <emmintrin.h>
+#endif
+
+//Algorithm used by binary_to_bcd() and bcd_to_binary(); select with
+//-DBCD_CONVERT=N (BCD_CONVERT variable in the Makefile).
+#define BCD_CONVERT_LOOP 0     //one digit at a time with / and %
+#define BCD_CONVERT_TABLE 1    //two digits per byte via lookup tables
+#define BCD_CONVERT_DABBLE 2   //double dabble (shift-and-add-3)
+
+#ifndef BCD_CONVERT
+  #define BCD_CONVERT BCD_CONVERT_TABLE
+#endif
 
 // Reverse string
 char *strrev(char *str)
@@ -42,22 +51,62 @@ char *strrev(char *str)
  *  If error is not NULL, sets *error to OVERFLOW_ERR if binary is too
  *  big for the Bcd type, otherwise *error is unchanged.
  */
+#if BCD_CONVERT == BCD_CONVERT_TABLE
+
 Bcd
 binary_to_bcd(Binary value, BcdError *error)
 {
-  //printf("Received Binary Number %llu\t", value);
+  if (value > BCD_MAX_BINARY) {
+    if (error) *error = OVERFLOW_ERR;
+    return 0;
+  }
+
+  // Four digits per iteration: the compiler turns / 10000 into a
+  // multiply by its reciprocal; r / 100 == (r * 5243) >> 19 exactly for
+  // all r < 43699.
+  unsigned long long v = value, result = 0;
+  for (int shift = 0; v != 0; shift += 4*BCD_BITS) {
+    unsigned long long q = v / 10000;
+    unsigned r = v - q*10000;
+    unsigned hi = (r * 5243) >> 19;
+    unsigned lo = r - hi*100;
+    result |= (unsigned long long)(BIN_TO_BCD2[hi] << 8 | BIN_TO_BCD2[lo])
+      << shift;
+    v = q;
+  }
+  return result;
+}
+
+#elif BCD_CONVERT == BCD_CONVERT_DABBLE
+
+Bcd
+binary_to_bcd(Binary value, BcdError *error)
+{
+  if (value > BCD_MAX_BINARY) {
+    if (error) *error = OVERFLOW_ERR;
+    return 0;
+  }
+
+  // Shift value in from its most-significant 1 bit, adding 3 to each
+  // digit >= 5 before every shift so that it carries decimally.
+  unsigned long long result = 0;
+  for (int i = (value == 0) ? -1 : 63 - __builtin_clzll(value); i >= 0; i--) {
+    result = bcd_swar_dabble_add3(result);
+    result = (result << 1) | ((value >> i) & 1);
+  }
+  return result;
+}
 
-  Binary tmp = value;
-  unsigned long long digits = 0;
-  do{
-    digits++;
-    tmp /= 10;
-  }while (tmp);
+#else //BCD_CONVERT == BCD_CONVERT_LOOP
 
+Bcd
+binary_to_bcd(Binary value, BcdError *error)
+{
+  //printf("Received Binary Number %llu\t", value);
 
-  if (MAX_BCD_DIGITS < digits)
+  if (value > BCD_MAX_BINARY)
   {
-    *error = OVERFLOW_ERR;
+    if (error) *error = OVERFLOW_ERR;
     return 0;
   }
 
@@ -70,6 +119,8 @@ binary_to_bcd(Binary value, BcdError *error)
   return result;
 }
 
+#endif //if BCD_CONVERT == BCD_CONVERT_TABLE
+
 /** Return binary encoding of BCD value bcd.
  *
  *  Examples: bcd_to_binary(0x12) => 0xc;
@@ -79,39 +130,148 @@ binary_to_bcd(Binary value, BcdError *error)
  *  a bad BCD digit.
  *  Cannot overflow since Binary can represent larger values than Bcd
  */
+#if BCD_CONVERT == BCD_CONVERT_TABLE
+
 Binary
 bcd_to_binary(Bcd bcd, BcdError *error)
 {
-  // Calculate how many digits there are
-  Bcd szTemp = bcd; Binary result = 0;
-  unsigned long long digits = 1;
-  while(szTemp >= 10)
-  {
-    szTemp /= 16;
-    digits++;
+  if (bcd_swar_bad_digits(bcd)) {
+    if (error) *error = BAD_VALUE_ERR;
+    return 0;
+  }
+
+  // Two digits per byte, most-significant byte first
+  unsigned long long result = 0;
+  for (int shift = (sizeof(Bcd) - 1)*CHAR_BIT; shift >= 0; shift -= CHAR_BIT) {
+    result = result*100 + BCD2_TO_BIN[(bcd >> shift) & 0xFF];
+  }
+  return result;
+}
+
+#elif BCD_CONVERT == BCD_CONVERT_DABBLE
+
+Binary
+bcd_to_binary(Bcd bcd, BcdError *error)
+{
+  if (bcd_swar_bad_digits(bcd)) {
+    if (error) *error = BAD_VALUE_ERR;
+    return 0;
   }
 
+  // Reverse double dabble: shift bits out of the bottom, subtracting 3
+  // from each digit >= 8 after every shift.
+  unsigned long long x = bcd, result = 0;
+  for (int i = 0; x != 0; i++) {
+    result |= (x & 1) << i;
+    x = bcd_swar_dabble_sub3(x >> 1);
+  }
+  return result;
+}
+
+#else //BCD_CONVERT == BCD_CONVERT_LOOP
+
+Binary
+bcd_to_binary(Bcd bcd, BcdError *error)
+{
+  // Calculate how many digits there are from the leading zero bits
+  Binary result = 0; int isBad = 0;
+  int digits = (bcd == 0) ? 1 : (67 - __builtin_clzll(bcd)) / BCD_BITS;
+
   // Cycle through all the nibbles individualy and translate them
-  for (unsigned long long index = 0; index < digits; index++)
+  for (int index = 0; index < digits; index++)
   {
     // Select the indexth nibble from the BCD.
     Binary nibble = bcd >> (BCD_BITS*index);
     nibble %= 16;
 
     // Error detection
-    if (nibble >= 10) *error = BAD_VALUE_ERR;
+    if (nibble >= 10) isBad = 1;
 
     // Add this digit to the result
-    result += nibble * power(10, index);
+    result += nibble * BCD_POW10[index];
   }
 
-  return *error == 0 ? result : 0; // i numeri sono finito, loro stanno in l'inferno
+  if (isBad && error) *error = BAD_VALUE_ERR;
+  return !isBad ? result : 0; // i numeri sono finito, loro stanno in l'inferno
 }
 
+#endif //if BCD_CONVERT == BCD_CONVERT_TABLE
+
+/** Set *value to the packed BCD digits at the start of s, of which
+ *  there may be at most 16, and return their number.
+ */
+#ifdef __SSE2__
+
+static int
+parse_digits16(const char *s, unsigned long long *value)
+{
+  // 1s in the first n bytes of a vector loaded from &FIRST_N[16 - n]
+  static const unsigned char FIRST_N[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  };
+
+  // A 16-byte load cannot fault unless it crosses into the next page;
+  // near the end of a page copy the string up to its NUL instead.
+  __m128i chars;
+  if (((uintptr_t)s & 4095) <= 4096 - 16) {
+    chars = _mm_loadu_si128((const __m128i *)s);
+  }
+  else {
+    char tmp[16] = { 0 };
+    for (int i = 0; i < 16 && s[i] != '\0'; i++) tmp[i] = s[i];
+    chars = _mm_loadu_si128((const __m128i *)tmp);
+  }
+
+  // a byte is a digit iff byte - '0' <= 9 as an unsigned byte
+  __m128i digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+  __m128i isDigit =
+    _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+  const int n = __builtin_ctz(~_mm_movemask_epi8(isDigit));
+  if (n == 0) {
+    *value = 0;
+    return 0;
+  }
+  digits = _mm_and_si128(digits,
+                         _mm_loadu_si128((const __m128i *)&FIRST_N[16 - n]));
+
+  // each 16-bit lane holds 2 digits as (lo, hi) bytes: pack them into
+  // hi:lo nybbles, then narrow the lanes to bytes
+  __m128i pairs =
+    _mm_or_si128(_mm_slli_epi16(_mm_and_si128(digits, _mm_set1_epi16(0xFF)),
+                                BCD_BITS),
+                 _mm_srli_epi16(digits, 8));
+  unsigned long long packed =
+    _mm_cvtsi128_si64(_mm_packus_epi16(pairs, pairs));
+
+  // the first digit is in the high nybble of byte 0: reverse the bytes
+  // and right-justify the n digits
+  *value = __builtin_bswap64(packed) >> (16 - n)*BCD_BITS;
+  return n;
+}
+
+#else //!__SSE2__
+
+static int
+parse_digits16(const char *s, unsigned long long *value)
+{
+  unsigned long long packed = 0;
+  int n;
+  for (n = 0; n < 16 && isdigit((unsigned char)s[n]); n++) {
+    packed = packed << BCD_BITS | (s[n] - '0');
+  }
+  *value = packed;
+  return n;
+}
+
+#endif //ifdef __SSE2__
+
 /** Return BCD encoding of decimal number corresponding to string s.
  *  Behavior undefined on overflow or if s contains a non-digit
  *  character.  Sets *p to point to first non-digit char in s.
- *  Rougly equivalent to strtol().
+ *  Rougly equivalent to strtol(): leading white space and an optional
+ *  '+' are skipped, but a Bcd is unsigned so a leading '-' is not a
+ *  number (0 is returned with *p set to s).
  *
  *  If error is not NULL, sets *error to OVERFLOW_ERR if binary is too
  *  big for the Bcd type, otherwise *error is unchanged.
@@ -119,10 +279,60 @@ bcd_to_binary(Bcd bcd, BcdError *error)
 Bcd
 str_to_bcd(const char *s, const char **p, BcdError *error)
 {
-  Binary val = strtoll(s, (char**)p, 10);
-  return binary_to_bcd(val, error);
+  // Pack the digits straight from the text: there is no binary value
+  const char *q = s;
+  while (isspace((unsigned char)*q)) q++;
+  if (*q == '+') q++;
+  const char *digits = q;
+  while (*q == '0') q++;                  //leading zeros: not significant
+
+  unsigned long long bcd;
+  const char *end = q + parse_digits16(q, &bcd);
+  if (end == q + 16) {
+    while (isdigit((unsigned char)*end)) end++;
+  }
+  if (end == digits) {                    //no digits: like strtol()
+    *p = s;
+    return 0;
+  }
+  *p = end;
+  if (end - q > MAX_BCD_DIGITS) {
+    if (error) *error = OVERFLOW_ERR;
+    return 0;
+  }
+  return bcd;
+}
+
+/** Set buf[0 ... 15] to the ASCII digits of the 16-digit bcd. */
+#ifdef __SSE2__
+
+static void
+format_digits16(unsigned long long bcd, char buf[16])
+{
+  // Byte-reverse so the most-significant digit pair comes first, then
+  // interleave the high and low nybbles of each byte as digit bytes.
+  __m128i pairs = _mm_cvtsi64_si128(__builtin_bswap64(bcd));
+  const __m128i lowNybbles = _mm_set1_epi8(0x0F);
+  __m128i hi = _mm_and_si128(_mm_srli_epi16(pairs, BCD_BITS), lowNybbles);
+  __m128i lo = _mm_and_si128(pairs, lowNybbles);
+  __m128i chars =
+    _mm_add_epi8(_mm_unpacklo_epi8(hi, lo), _mm_set1_epi8('0'));
+  _mm_storeu_si128((__m128i *)buf, chars);
 }
 
+#else //!__SSE2__
+
+static void
+format_digits16(unsigned long long bcd, char buf[16])
+{
+  for (int i = 15; i >= 0; i--) {
+    buf[i] = '0' + (bcd & 0xF);
+    bcd >>= BCD_BITS;
+  }
+}
+
+#endif //ifdef __SSE2__
+
 /** Convert bcd to a NUL-terminated string in buf[] without any
  *  non-significant leading zeros.  Never write more than bufSize
  *  characters into buf.  The return value is the number of characters
@@ -135,20 +345,22 @@ str_to_bcd(const char *s, const char **p, BcdError *error)
 int
 bcd_to_str(Bcd bcd, char buf[], size_t bufSize, BcdError *error)
 {
-  if (bufSize < BCD_BUF_SIZE) *error=OVERFLOW_ERR;
-
-  sprintf(buf, "%llx", (unsigned long long)bcd);
-
-  Bcd tmp = bcd;
-
-  while (tmp)
-  {
-    if ((tmp % 16) > 9) *error = BAD_VALUE_ERR;
-    tmp /= 16;
+  if (bcd_swar_bad_digits(bcd)) {
+    if (error) *error = BAD_VALUE_ERR;
+    return 0;
+  }
+  if (bufSize < BCD_BUF_SIZE) {
+    if (error) *error = OVERFLOW_ERR;
+    return 0;
   }
 
-  // Convert value to a string, one digit at at time.
-  return *error == 0 ? strlen(buf) : 0;
+  // # of significant digits from the leading zero bits (1 for 0)
+  const int n = (bcd == 0) ? 1 : (67 - __builtin_clzll(bcd)) / BCD_BITS;
+  char digits[16];
+  format_digits16(bcd, digits);
+  memcpy(buf, &digits[16 - n], n);
+  buf[n] = '\0';
+  return n;
 }
 
 /** Return the BCD representation of the sum of BCD int's x and y.
@@ -160,11 +372,82 @@ bcd_to_str(Bcd bcd, char buf[], size_t bufSize, BcdError *error)
 Bcd
 bcd_add(Bcd x, Bcd y, BcdError *error)
 {
-  // Convert both x and y to decimal, return the sum
-  Binary bin_x = bcd_to_binary(x, error);
-  Binary bin_y = bcd_to_binary(y, error);
+  // Add all the digits at once without leaving packed BCD
+  if (bcd_swar_bad_digits(x) | bcd_swar_bad_digits(y)) {
+    if (error) *error = BAD_VALUE_ERR;
+    return 0;
+  }
 
-  return binary_to_bcd(bin_x + bin_y, error);
+  // A narrower Bcd overflows into the zero digits above it
+  unsigned carry;
+  unsigned long long sum = bcd_swar_add(x, y, 0, &carry);
+  if (carry || sum != (Bcd)sum) {
+    if (error) *error = OVERFLOW_ERR;
+    return 0;
+  }
+
+  return sum;
+}
+
+/** Set multLo[d] to the 16 least-significant digits of the packed BCD
+ *  d * x for each digit d and multHi[d] to its 17th digit: the partial
+ *  products, built with the packed adder.
+ */
+static void
+make_multiples(unsigned long long x, unsigned long long multLo[10],
+               unsigned multHi[10])
+{
+  multLo[0] = multHi[0] = 0;
+  for (int d = 1; d < 10; d++) {
+    unsigned carry;
+    multLo[d] = bcd_swar_add(multLo[d - 1], x, 0, &carry);
+    multHi[d] = multHi[d - 1] + carry;
+  }
+}
+
+/** Return the # of significant digits in bcd (0 for 0) */
+static int
+n_bcd_digits(unsigned long long bcd)
+{
+  return (bcd == 0) ? 0 : (67 - __builtin_clzll(bcd)) / BCD_BITS;
+}
+
+/** Return the MAX_BCD_DIGITS least-significant digits of the BCD
+ *  product of x and y and set *hi to its MAX_BCD_DIGITS
+ *  most-significant digits; the full product never overflows.
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if x or y
+ *  contains a BCD digit which is greater than 9 (the result and *hi
+ *  are then 0), otherwise *error is unchanged.
+ */
+Bcd
+bcd_multiply_wide(Bcd x, Bcd y, Bcd *hi, BcdError *error)
+{
+  *hi = 0;
+  if (bcd_swar_bad_digits(x) | bcd_swar_bad_digits(y)) {
+    if (error) *error = BAD_VALUE_ERR;
+    return 0;
+  }
+
+  unsigned long long multLo[10];
+  unsigned multHi[10];
+  make_multiples(x, multLo, multHi);
+
+  // Horner's rule over the digits of y from the most-significant one:
+  // shift the double-width product left one digit, then add d * x.
+  unsigned long long lo = 0, hiDigits = 0;
+  for (int i = n_bcd_digits(y) - 1; i >= 0; i--) {
+    const unsigned d = (y >> i*BCD_BITS) & 0xF;
+    unsigned carry;
+    hiDigits = hiDigits << BCD_BITS | lo >> (64 - BCD_BITS);
+    lo = bcd_swar_add(lo << BCD_BITS, multLo[d], 0, &carry);
+    hiDigits = bcd_swar_add(hiDigits, multHi[d], carry, &carry);
+  }
+
+  // A narrower Bcd's whole product is in lo (the double shift is 0 for
+  // a 64-bit Bcd, whose high digits are in hiDigits instead).
+  *hi = (lo >> (MAX_BCD_DIGITS*BCD_BITS - 1) >> 1) | hiDigits;
+  return lo;
 }
 
 /** Return the BCD representation of the product of BCD int's x and y.
@@ -176,9 +459,125 @@ bcd_add(Bcd x, Bcd y, BcdError *error)
 Bcd
 bcd_multiply(Bcd x, Bcd y, BcdError *error)
 {
-  // Convert both x and y to decimal, return the product
-  Binary bin_x = bcd_to_binary(x, error);
-  Binary bin_y = bcd_to_binary(y, error);
+  // Multiply decimally: the product overflows iff it has high digits
+  Bcd hi;
+  Bcd product = bcd_multiply_wide(x, y, &hi, error);
+  if (hi != 0) {
+    if (error) *error = OVERFLOW_ERR;
+    return 0;
+  }
+  return product;
+}
+
+/** Return the BCD representation of the difference x - y.
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if x or y
+ *  contains a BCD digit which is greater than 9, OVERFLOW_ERR if
+ *  x < y (the result is then 0), otherwise *error is unchanged.
+ */
+Bcd
+bcd_subtract(Bcd x, Bcd y, BcdError *error)
+{
+  // Add the 9's complement of y plus 1: no borrow out of the top digit
+  // iff x >= y, whatever the width of the Bcd
+  if (bcd_swar_bad_digits(x) | bcd_swar_bad_digits(y)) {
+    if (error) *error = BAD_VALUE_ERR;
+    return 0;
+  }
+  unsigned borrow;
+  unsigned long long diff = bcd_swar_sub(x, y, 0, &borrow);
+  if (borrow) {
+    if (error) *error = OVERFLOW_ERR;
+    return 0;
+  }
+  return diff;
+}
+
+/** Return < 0, 0 or > 0 as BCD x is less than, equal to or greater
+ *  than BCD y.
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if x or y
+ *  contains a BCD digit which is greater than 9 (the result is then
+ *  0), otherwise *error is unchanged.
+ */
+int
+bcd_compare(Bcd x, Bcd y, BcdError *error)
+{
+  // Valid packed BCD orders the same as its binary value
+  if (bcd_swar_bad_digits(x) | bcd_swar_bad_digits(y)) {
+    if (error) *error = BAD_VALUE_ERR;
+    return 0;
+  }
+  return (x > y) - (x < y);
+}
 
-  return binary_to_bcd(bin_x * bin_y, error);
-}
\ No newline at end of file
+/** Return the BCD quotient x / y and set *rem (if rem is not NULL) to
+ *  the BCD remainder x % y.
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if x or y
+ *  contains a BCD digit which is greater than 9 or y is 0 (the
+ *  quotient and *rem are then 0), otherwise *error is unchanged.
+ */
+Bcd
+bcd_divmod(Bcd x, Bcd y, Bcd *rem, BcdError *error)
+{
+  if (rem) *rem = 0;
+  if (bcd_swar_bad_digits(x) | bcd_swar_bad_digits(y) | (y == 0)) {
+    if (error) *error = BAD_VALUE_ERR;
+    return 0;
+  }
+
+  // Long division over the digits of x from the most-significant one:
+  // bring the next digit down into the remainder r < y, then the
+  // quotient digit is the # of multiples 1*y ... 9*y which are <= r.
+  // Packed BCD compares like binary; r and the multiples may have a
+  // 17th digit when a Bcd has 16.
+  unsigned long long multLo[10];
+  unsigned multHi[10];
+  make_multiples(y, multLo, multHi);
+  unsigned long long r = 0, quotient = 0;
+  for (int i = n_bcd_digits(x) - 1; i >= 0; i--) {
+    const unsigned rHi = r >> (64 - BCD_BITS);
+    r = r << BCD_BITS | ((x >> i*BCD_BITS) & 0xF);
+    unsigned q = 0;
+    for (int d = 1; d < 10; d++) {
+      q += (rHi > multHi[d]) || (rHi == multHi[d] && r >= multLo[d]);
+    }
+    // r - q*y < y fits in 16 digits: ignore the borrow from a 17th
+    unsigned borrow;
+    r = bcd_swar_sub(r, multLo[q], 0, &borrow);
+    quotient = quotient << BCD_BITS | q;
+  }
+  if (rem) *rem = r;
+  return quotient;
+}
+
+/** Return the BCD quotient of x divided by the binary divisor and set
+ *  *rem (if rem is not NULL) to the binary remainder.
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if x contains a
+ *  BCD digit which is greater than 9 or divisor is 0 (the quotient
+ *  and *rem are then 0), otherwise *error is unchanged.
+ */
+Bcd
+bcd_div_small(Bcd x, unsigned divisor, unsigned *rem, BcdError *error)
+{
+  if (rem) *rem = 0;
+  if (bcd_swar_bad_digits(x) || divisor == 0) {
+    if (error) *error = BAD_VALUE_ERR;
+    return 0;
+  }
+
+  // Short division two digits (one byte) at a time from the
+  // most-significant byte: with r < divisor, r*100 + byte fits in 64
+  // bits and its quotient by divisor is < 100.
+  unsigned long long r = 0, quotient = 0;
+  for (int shift = (sizeof(Bcd) - 1)*CHAR_BIT; shift >= 0; shift -= CHAR_BIT) {
+    const unsigned long long n = r*100 + BCD2_TO_BIN[(x >> shift) & 0xFF];
+    const unsigned q = n / divisor;
+    r = n - (unsigned long long)q*divisor;
+    quotient = quotient << CHAR_BIT | BIN_TO_BCD2[q];
+  }
+  if (rem) *rem = r;
+  return quotient;
+}
@@ -66,6 +66,12 @@ enum {
   BCD_BUF_SIZE = MAX_BCD_DIGITS + 1
 };
 
+//largest binary value representable in a Bcd: all 9's
+#define BCD_MAX_BINARY \
+  ((MAX_BCD_DIGITS == 2) ? 99ULL : \
+   (MAX_BCD_DIGITS == 4) ? 9999ULL : \
+   (MAX_BCD_DIGITS == 8) ? 99999999ULL : 9999999999999999ULL)
+
 //error codes returned by following API
 typedef enum {
   OK_ERR,                  //no error
@@ -104,7 +110,9 @@ Binary bcd_to_binary(Bcd bcd, BcdError *error);
 /** Return BCD encoding of decimal number corresponding to string s.
  *  Behavior undefined on overflow or if s contains a non-digit
  *  character.  Sets *p to point to first non-digit char in s.
- *  Rougly equivalent to strtol().
+ *  Rougly equivalent to strtol(): leading white space and an optional
+ *  '+' are skipped, but a Bcd is unsigned so a leading '-' is not a
+ *  number (0 is returned with *p set to s).
  *
  *  If error is not NULL, sets *error to OVERFLOW_ERR if binary is too
  *  big for the Bcd type, otherwise *error is unchanged.
@@ -138,5 +146,58 @@ Bcd bcd_add(Bcd x, Bcd y, BcdError *error);
  */
 Bcd bcd_multiply(Bcd x, Bcd y, BcdError *error);
 
+/** Return the MAX_BCD_DIGITS least-significant digits of the BCD
+ *  product of x and y and set *hi to its MAX_BCD_DIGITS
+ *  most-significant digits; the full product never overflows.
+ *
+ *  Example: with 4-digit Bcd's, bcd_multiply_wide(0x9999, 0x9999, &hi)
+ *           => 0x0001 with hi == 0x9998
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if x or y
+ *  contains a BCD digit which is greater than 9 (the result and *hi
+ *  are then 0), otherwise *error is unchanged.
+ */
+Bcd bcd_multiply_wide(Bcd x, Bcd y, Bcd *hi, BcdError *error);
+
+/** Return the BCD representation of the difference x - y.
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if x or y
+ *  contains a BCD digit which is greater than 9, OVERFLOW_ERR if
+ *  x < y (the result is then 0), otherwise *error is unchanged.
+ */
+Bcd bcd_subtract(Bcd x, Bcd y, BcdError *error);
+
+/** Return < 0, 0 or > 0 as BCD x is less than, equal to or greater
+ *  than BCD y.
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if x or y
+ *  contains a BCD digit which is greater than 9 (the result is then
+ *  0), otherwise *error is unchanged.
+ */
+int bcd_compare(Bcd x, Bcd y, BcdError *error);
+
+/** Return the BCD quotient x / y and set *rem (if rem is not NULL) to
+ *  the BCD remainder x % y.
+ *
+ *  Example: bcd_divmod(0x1234, 0x56, &rem) => 0x22 with rem == 0x2
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if x or y
+ *  contains a BCD digit which is greater than 9 or y is 0 (the
+ *  quotient and *rem are then 0), otherwise *error is unchanged.
+ */
+Bcd bcd_divmod(Bcd x, Bcd y, Bcd *rem, BcdError *error);
+
+/** Return the BCD quotient of x divided by the binary divisor and set
+ *  *rem (if rem is not NULL) to the binary remainder.  Faster than
+ *  bcd_divmod() when the divisor is already a binary number.
+ *
+ *  Example: bcd_div_small(0x1234, 7, &rem) => 0x176 with rem == 2
+ *
+ *  If error is not NULL, sets *error to BAD_VALUE_ERR if x contains a
+ *  BCD digit which is greater than 9 or divisor is 0 (the quotient
+ *  and *rem are then 0), otherwise *error is unchanged.
+ */
+Bcd bcd_div_small(Bcd x, unsigned divisor, unsigned *rem, BcdError *error);
+
 #endif //ifndef BCD_H_
 
@@ -1,10 +1,13 @@
 
 
 #include "bcd.h"
+#include "bcd-calc.h"
 
 #include <ctype.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 static inline const char *
@@ -29,9 +32,39 @@ is_error(BcdError err)
   return 0;
 }
 
+static void
+usage(const char *prog)
+{
+  fprintf(stderr, "usage: %s [-b FILE [-j N_THREADS]]\n", prog);
+  fprintf(stderr, "  -b FILE: evaluate each line of FILE, writing one "
+          "output line per input line\n");
+  fprintf(stderr, "  -j N_THREADS: split FILE across N_THREADS threads\n");
+  exit(1);
+}
+
 int
-main()
+main(int argc, char *argv[])
 {
+  const char *batchFile = NULL;
+  int nThreads = 1;
+  bool hasJobs = false;         //-j given: only valid with -b
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+      batchFile = argv[++i];
+    }
+    else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+      char *end;
+      nThreads = strtol(argv[++i], &end, 10);
+      if (*end != '\0' || nThreads < 1) usage(argv[0]);
+      hasJobs = true;
+    }
+    else {
+      usage(argv[0]);
+    }
+  }
+  if (hasJobs && !batchFile) usage(argv[0]);
+  if (batchFile) return calc_file(batchFile, nThreads, stdout);
+
   enum { LINE_MAX = 80 };
   char line[LINE_MAX];
   printf("BCD_BASE == %d, sizeof(Bcd) == %zu\n", BCD_BASE, sizeof(Bcd));
@@ -3,6 +3,7 @@
 #include "y86.h"
 #include "yas.h"
 #include "ysim.h"
+#include "ymulti.h"
 
 #include "errors.h"
 
@@ -21,10 +22,13 @@ typedef struct {
   int verbosity;
   bool isStep;
   bool isList;
+  int nMulti;
 } Args;
 
 enum { SILENT_VERBOSE, VERBOSE, VERY_VERBOSE };
 
+enum { DEFAULT_N_MULTI = 16 };
+
 /**************************** Y86 Parameter Setup ***********************/
 
 
@@ -73,6 +77,44 @@ simulate(const Args *args, Y86 *y86, FILE *out)
   dump_changes_y86(y86, true, out);
 }
 
+/** Run each file in args as an independent program, args->nMulti
+ *  programs at a time interleaved on this thread.  Final state is
+ *  dumped for each program in command-line order.
+ */
+static void
+simulate_multi(const Args *args, FILE *out)
+{
+  const int k = args->nMulti;
+  for (int base = 0; base < args->numFileNames; base += k) {
+    const int nLeft = args->numFileNames - base;
+    const int n = (nLeft < k) ? nLeft : k;
+    Y86 *y86s[n];
+    const char *names[n];
+    int nLoaded = 0;
+    for (int i = 0; i < n; i++) {
+      const char *name = args->fileNames[base + i];
+      Y86 *y86 = new_y86_default();
+      if (yas_to_y86(y86, 1, &name)) {
+        setup_params(args, y86);
+        y86s[nLoaded] = y86; names[nLoaded] = name;
+        nLoaded++;
+      }
+      else {
+        free_y86(y86);
+      }
+    }
+    if (nLoaded == 0) continue;
+    YMulti *ymulti = new_ymulti(nLoaded, y86s);
+    run_ymulti(ymulti, YMULTI_QUANTUM);
+    for (int i = 0; i < nLoaded; i++) {
+      fprintf(out, "==> %s <==\n", names[i]);
+      dump_changes_y86(y86s[i], true, out);
+      free_y86(y86s[i]);
+    }
+    free_ymulti(ymulti);
+  }
+}
+
 
 /************************* Parse Command Line **************************/
 
@@ -80,13 +122,16 @@ static void
 usage(const char *prog)
 {
   fprintf(stderr,
-          "usage: %s [-s] [-v] [-V] YAS_FILE_NAMES... INT_INPUTS...\n", prog);
+          "usage: %s [-s] [-v] [-V] [-m[K]] YAS_FILE_NAMES... INT_INPUTS...\n",
+          prog);
   fprintf(stderr,
           "          -l:  produce assembler listing only\n"
+          "          -m:  run each file as a separate program, K (default %d)\n"
+          "               at a time interleaved; -s, -v, -V are ignored\n"
           "          -s:  single-step program\n"
           "          -v:  verbose: dump changes after each instruction\n"
           "          -V:  very verbose: dump all registers after each "
-          "instruction\n");
+          "instruction\n", DEFAULT_N_MULTI);
   exit(1);
 }
 
@@ -107,6 +152,15 @@ first_pass_args(int argc, const char *argv[], Args *args)
     else if (strcmp(argv[i], "-l") == 0) {
       args->isList = true;
     }
+    else if (strncmp(argv[i], "-m", 2) == 0) {
+      char *p;
+      args->nMulti = (argv[i][2] == '\0')
+        ? DEFAULT_N_MULTI : strtol(&argv[i][2], &p, 10);
+      if (args->nMulti <= 0 || (argv[i][2] != '\0' && *p != '\0')) {
+        fprintf(stderr, "bad multi-program count in '%s'\n", argv[i]);
+        usage(argv[0]);
+      }
+    }
     else if (argv[i][0] == '-' && !isdigit(argv[i][1])) {
       fprintf(stderr, "unknown option '%s'\n", argv[i]);
       usage(argv[0]);
@@ -164,6 +218,9 @@ main(int argc, const char *argv[])
   if (args.isList) {
     yas_to_listing(stdout, args.numFileNames, args.fileNames);
   }
+  else if (args.nMulti > 0) {
+    simulate_multi(&args, stdout);
+  }
   else {
     Y86 *y86 = new_y86_default();
     if (yas_to_y86(y86, args.numFileNames, args.fileNames)) {
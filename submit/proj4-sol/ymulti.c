@@ -0,0 +1,63 @@
+
+
+#include "ymulti.h"
+#include "ysim.h"
+
+#include <stdlib.h>
+#include "errors.h"
+
+/** Return a newly allocated group for the nContexts contexts y86s[].
+ *  The contexts must already be loaded; y86s[] must outlive the group.
+ */
+YMulti *
+new_ymulti(int nContexts, Y86 *y86s[])
+{
+  YMulti *ymulti = calloc(1, sizeof(YMulti));
+  int *live = calloc(nContexts, sizeof(int));
+  if (!ymulti || !live) {
+    fatal("cannot allocate group of %d y86 contexts\n", nContexts);
+  }
+  ymulti->nContexts = nContexts;
+  ymulti->y86s = y86s;
+  ymulti->live = live;
+  for (int i = 0; i < nContexts; i++) {
+    if (read_status_y86(y86s[i]) == STATUS_AOK) live[ymulti->nLive++] = i;
+  }
+  return ymulti;
+}
+
+/** Free group ymulti; its contexts are not freed. */
+void
+free_ymulti(YMulti *ymulti)
+{
+  free(ymulti->live);
+  free(ymulti);
+}
+
+/** Run all contexts in ymulti until every one has left STATUS_AOK,
+ *  interleaving the live contexts quantum instructions at a time.
+ */
+void
+run_ymulti(YMulti *ymulti, int quantum)
+{
+  int *live = ymulti->live;
+  while (ymulti->nLive > 0) {
+    for (int i = 0; i < ymulti->nLive; ) {
+      const int c = live[i];
+      Y86 *y86 = ymulti->y86s[c];
+      Status status = STATUS_AOK;
+      for (int q = 0; q < quantum && status == STATUS_AOK; q++) {
+        step_ysim(y86);
+        status = read_status_y86(y86);
+      }
+      if (status == STATUS_AOK) {
+        i++;
+      }
+      else {
+        //retire context: move last live context into its slot
+        live[i] = live[--ymulti->nLive];
+      }
+    }
+  }
+}
+
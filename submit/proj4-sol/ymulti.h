@@ -0,0 +1,37 @@
+
+
+#ifndef _YMULTI_H
+#define _YMULTI_H
+
+#include "y86.h"
+
+/** Number of instructions a context runs before the next live context
+ *  gets its turn.
+ */
+enum { YMULTI_QUANTUM = 8 };
+
+/** Scheduling state for a group of independent Y86 contexts: the
+ *  round-robin loop visits only the contexts listed in live[].
+ */
+typedef struct {
+  int nContexts;            /** # of contexts in the group */
+  Y86 **y86s;               /** [nContexts] contexts, owned by caller */
+  int nLive;                /** # of entries in live[] */
+  int *live;                /** [nLive] indexes of still-running contexts */
+} YMulti;
+
+/** Return a newly allocated group for the nContexts contexts y86s[].
+ *  The contexts must already be loaded; y86s[] must outlive the group.
+ */
+YMulti *new_ymulti(int nContexts, Y86 *y86s[]);
+
+/** Free group ymulti; its contexts are not freed. */
+void free_ymulti(YMulti *ymulti);
+
+/** Run all contexts in ymulti until every one has left STATUS_AOK,
+ *  interleaving the live contexts quantum instructions at a time.
+ */
+void run_ymulti(YMulti *ymulti, int quantum);
+
+#endif //ifndef _YMULTI_H
+
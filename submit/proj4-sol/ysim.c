@@ -1,13 +1,14 @@
 
 
 #include "ysim.h"
+#include "ytrap.h"
 #include <stdio.h>
 #include "errors.h"
 
 typedef enum {
   HALT_CODE, NOP_CODE, CMOVxx_CODE, IRMOVQ_CODE, RMMOVQ_CODE, MRMOVQ_CODE,
   OP1_CODE, Jxx_CODE, CALL_CODE, RET_CODE,
-  PUSHQ_CODE, POPQ_CODE } BaseOpCode;
+  PUSHQ_CODE, POPQ_CODE, TRAP_CODE } BaseOpCode;
 
 /************************** Utility Routines ****************************/
 
@@ -300,6 +301,12 @@ step_ysim(Y86 *y86)
       write_pc_y86(y86, counter+(2*sizeof(Byte)));
       break;
       
+/** Host Services (see ytrap.h) **/
+
+    case TRAP_CODE:
+      trap_ysim(y86, instruction);
+      return;
+
 /** Jump, OP1 (ALU) **/
       
     case Jxx_CODE:
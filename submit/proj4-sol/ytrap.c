@@ -0,0 +1,192 @@
+
+
+#include "ytrap.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/** Host-side staging buffer: guest memory is only reachable through
+ *  the y86 accessors, so transfers are done a block at a time.
+ */
+enum { TRAP_BUF_SIZE = 64 * 1024 };
+
+static Byte trapBuf[TRAP_BUF_SIZE];
+
+/************************** Utility Routines ****************************/
+
+static inline Word
+min_word(Word a, Word b)
+{
+  return (a < b) ? a : b;
+}
+
+/** Return true iff [addr, addr + count) lies within y86 memory */
+static bool
+in_bounds(const Y86 *y86, Address addr, Word count)
+{
+  Address size = get_memory_size_y86(y86);
+  return count <= size && addr <= size - count;
+}
+
+/** Copy n bytes of y86 memory at addr to buf[], a word at a time
+ *  where possible (Y86 words are little-endian, as is the host).
+ */
+static void
+copy_from_y86(Y86 *y86, Address addr, Byte buf[], Word n)
+{
+  Word i = 0;
+  for (; i + sizeof(Word) <= n; i += sizeof(Word)) {
+    Word word = read_memory_word_y86(y86, addr + i);
+    memcpy(&buf[i], &word, sizeof(Word));
+  }
+  for (; i < n; i++) {
+    buf[i] = read_memory_byte_y86(y86, addr + i);
+  }
+}
+
+/** Copy n bytes from buf[] to y86 memory at addr */
+static void
+copy_to_y86(Y86 *y86, Address addr, const Byte buf[], Word n)
+{
+  Word i = 0;
+  for (; i + sizeof(Word) <= n; i += sizeof(Word)) {
+    Word word;
+    memcpy(&word, &buf[i], sizeof(Word));
+    write_memory_word_y86(y86, addr + i, word);
+  }
+  for (; i < n; i++) {
+    write_memory_byte_y86(y86, addr + i, buf[i]);
+  }
+}
+
+/***************************** Services *******************************/
+
+/** read() up to count bytes from fd into y86 memory at addr.  Stops
+ *  early on EOF or a short read so interactive input is not blocked.
+ */
+static Word
+trap_read(Y86 *y86, int fd, Address addr, Word count)
+{
+  Word done = 0;
+  while (done < count) {
+    Word n = min_word(count - done, TRAP_BUF_SIZE);
+    ssize_t nRead = read(fd, trapBuf, n);
+    if (nRead < 0) return (done > 0) ? done : (Word)-1;
+    if (nRead == 0) break;
+    copy_to_y86(y86, addr + done, trapBuf, nRead);
+    done += nRead;
+    if ((Word)nRead < n) break;
+  }
+  return done;
+}
+
+/** write() count bytes of y86 memory at addr to fd */
+static Word
+trap_write(Y86 *y86, int fd, Address addr, Word count)
+{
+  //keep guest output ordered with the simulator's own stdout output
+  if (fd == STDOUT_FILENO) fflush(stdout);
+  Word done = 0;
+  while (done < count) {
+    Word n = min_word(count - done, TRAP_BUF_SIZE);
+    copy_from_y86(y86, addr + done, trapBuf, n);
+    for (Word i = 0; i < n; ) {
+      ssize_t nWritten = write(fd, &trapBuf[i], n - i);
+      if (nWritten < 0) return (done + i > 0) ? done + i : (Word)-1;
+      i += nWritten;
+    }
+    done += n;
+  }
+  return done;
+}
+
+/** Copy count bytes from src to dest with memmove() semantics */
+static void
+trap_memcpy(Y86 *y86, Address dest, Address src, Word count)
+{
+  if (dest > src && dest < src + count) {
+    //overlapping with dest above src: copy blocks from the end
+    for (Word left = count; left > 0; ) {
+      Word n = min_word(left, TRAP_BUF_SIZE);
+      left -= n;
+      copy_from_y86(y86, src + left, trapBuf, n);
+      copy_to_y86(y86, dest + left, trapBuf, n);
+    }
+  }
+  else {
+    for (Word done = 0; done < count; ) {
+      Word n = min_word(count - done, TRAP_BUF_SIZE);
+      copy_from_y86(y86, src + done, trapBuf, n);
+      copy_to_y86(y86, dest + done, trapBuf, n);
+      done += n;
+    }
+  }
+}
+
+/** Set count bytes at dest to value */
+static void
+trap_memset(Y86 *y86, Address dest, Byte value, Word count)
+{
+  memset(trapBuf, value, min_word(count, TRAP_BUF_SIZE));
+  for (Word done = 0; done < count; ) {
+    Word n = min_word(count - done, TRAP_BUF_SIZE);
+    copy_to_y86(y86, dest + done, trapBuf, n);
+    done += n;
+  }
+}
+
+/*************************** Trap Dispatch *****************************/
+
+/** Execute the trap instruction op at the pc of y86 and advance the
+ *  pc past it.  Changes status of y86 to STATUS_ADR if a buffer
+ *  falls outside y86 memory or STATUS_INS on an unknown service.
+ */
+void
+trap_ysim(Y86 *y86, Byte op)
+{
+  Address pc = read_pc_y86(y86);
+  Word rdi = read_register_y86(y86, REG_RDI);
+  Word rsi = read_register_y86(y86, REG_RSI);
+  Word rdx = read_register_y86(y86, REG_RDX);
+  Word result = 0;
+  TrapFn fn = op & 0xF;
+  switch (fn) {
+    case TRAP_READ_FN:
+      if (!in_bounds(y86, rsi, rdx)) {
+        write_status_y86(y86, STATUS_ADR);
+        return;
+      }
+      result = trap_read(y86, (int)rdi, rsi, rdx);
+      break;
+    case TRAP_WRITE_FN:
+      if (!in_bounds(y86, rsi, rdx)) {
+        write_status_y86(y86, STATUS_ADR);
+        return;
+      }
+      result = trap_write(y86, (int)rdi, rsi, rdx);
+      break;
+    case TRAP_MEMCPY_FN:
+      if (!in_bounds(y86, rdi, rdx) || !in_bounds(y86, rsi, rdx)) {
+        write_status_y86(y86, STATUS_ADR);
+        return;
+      }
+      trap_memcpy(y86, rdi, rsi, rdx);
+      result = rdi;
+      break;
+    case TRAP_MEMSET_FN:
+      if (!in_bounds(y86, rdi, rdx)) {
+        write_status_y86(y86, STATUS_ADR);
+        return;
+      }
+      trap_memset(y86, rdi, rsi & 0xFF, rdx);
+      result = rdi;
+      break;
+    default:
+      write_status_y86(y86, STATUS_INS);
+      return;
+  }
+  write_register_y86(y86, REG_RAX, result);
+  write_pc_y86(y86, pc + sizeof(Byte));
+}
+
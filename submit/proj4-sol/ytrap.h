@@ -0,0 +1,33 @@
+
+
+#ifndef _YTRAP_H
+#define _YTRAP_H
+
+#include "y86.h"
+
+/** A trap instruction is the single byte TRAP_OP with the requested
+ *  service in its low nybble.  Arguments are passed in %rdi, %rsi and
+ *  %rdx as for a C call and the result is returned in %rax.
+ *
+ *    trap read   (0xc0):  rax = read(fd=rdi, buf=rsi, count=rdx)
+ *    trap write  (0xc1):  rax = write(fd=rdi, buf=rsi, count=rdx)
+ *    trap memcpy (0xc2):  copy rdx bytes from rsi to rdi (may overlap)
+ *    trap memset (0xc3):  set rdx bytes at rdi to low byte of rsi
+ *
+ *  read and write return the number of bytes transferred (0 on EOF)
+ *  or -1 on a host error; memcpy and memset return rdi.
+ */
+enum { TRAP_OP = 0xC0 };
+
+typedef enum {
+  TRAP_READ_FN, TRAP_WRITE_FN, TRAP_MEMCPY_FN, TRAP_MEMSET_FN
+} TrapFn;
+
+/** Execute the trap instruction op at the pc of y86 and advance the
+ *  pc past it.  Changes status of y86 to STATUS_ADR if a buffer
+ *  falls outside y86 memory or STATUS_INS on an unknown service.
+ */
+void trap_ysim(Y86 *y86, Byte op);
+
+#endif //ifndef _YTRAP_H
+